@@ -0,0 +1,275 @@
+/******************************************************************************
+ * File Name: app_stats.cpp
+ *
+ * Description:
+ *   This file contains the counters of network stack suspension and HTTP
+ *   server activity reported by the statistics pages. The counters are
+ *   updated with atomic operations, so they can be updated from any thread.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "app_stats.h"
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+static app_stats_t app_stats;
+
+static log2_histogram_t app_stats_hist[APP_STATS_HIST_MAX];
+
+static const char* const app_stats_hist_names[APP_STATS_HIST_MAX] = {
+    "Sleep episode",
+    "Suspend latency",
+    "Resume latency"
+};
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: app_stats_nw_suspend_attempt
+ ******************************************************************************
+ * Summary:
+ *   This function counts an attempt to suspend the network stack.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_nw_suspend_attempt(void)
+{
+    core_util_atomic_incr_u32(&app_stats.nw_suspend_attempts, 1);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_nw_suspended
+ ******************************************************************************
+ * Summary:
+ *   This function counts a suspend of the network stack. It is called once
+ *   the stack has been resumed again.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_nw_suspended(void)
+{
+    core_util_atomic_incr_u32(&app_stats.nw_suspends, 1);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_nw_suspend_abandoned
+ ******************************************************************************
+ * Summary:
+ *   This function counts a sleep request that was dropped without a suspend
+ *   of the network stack, because no inactive window was found in
+ *   nw-suspend-search-ms or because wait_net_suspend() failed.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_nw_suspend_abandoned(void)
+{
+    core_util_atomic_incr_u32(&app_stats.nw_suspend_abandoned, 1);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_http_request
+ ******************************************************************************
+ * Summary:
+ *   This function counts a request served by a dynamic page.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_http_request(void)
+{
+    core_util_atomic_incr_u32(&app_stats.http_requests, 1);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_http_bytes_sent
+ ******************************************************************************
+ * Summary:
+ *   This function adds to the number of response bytes sent.
+ *
+ * Parameters:
+ *   bytes: Number of bytes written to a response stream.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_http_bytes_sent(uint32_t bytes)
+{
+    core_util_atomic_incr_u64(&app_stats.http_bytes_sent, bytes);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_http_eviction_pass
+ ******************************************************************************
+ * Summary:
+ *   This function counts a pass that closed all the HTTP connections before
+ *   a suspend of the network stack. The HTTP server library does not report
+ *   how many connections a pass closed, so passes are counted, not
+ *   connections.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_http_eviction_pass(void)
+{
+    core_util_atomic_incr_u32(&app_stats.http_eviction_passes, 1);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_http_drain_timeout
+ ******************************************************************************
+ * Summary:
+ *   This function counts a suspend of the network stack that went ahead
+ *   with HTTP response data still unsent or unacknowledged, because the
+ *   client did not acknowledge it in time.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_http_drain_timeout(void)
+{
+    core_util_atomic_incr_u32(&app_stats.http_drain_timeouts, 1);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_get
+ ******************************************************************************
+ * Summary:
+ *   This function takes a snapshot of the counters.
+ *
+ * Parameters:
+ *   stats: Pointer to the structure that receives the counters.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_get(app_stats_t *stats)
+{
+    stats->nw_suspend_attempts  = core_util_atomic_load_u32(&app_stats.nw_suspend_attempts);
+    stats->nw_suspends          = core_util_atomic_load_u32(&app_stats.nw_suspends);
+    stats->nw_suspend_abandoned = core_util_atomic_load_u32(&app_stats.nw_suspend_abandoned);
+    stats->http_requests        = core_util_atomic_load_u32(&app_stats.http_requests);
+    stats->http_bytes_sent      = core_util_atomic_load_u64(&app_stats.http_bytes_sent);
+    stats->http_eviction_passes = core_util_atomic_load_u32(&app_stats.http_eviction_passes);
+    stats->http_drain_timeouts  = core_util_atomic_load_u32(&app_stats.http_drain_timeouts);
+}
+
+
+/******************************************************************************
+ * Function Name: app_stats_record
+ ******************************************************************************
+ * Summary:
+ *   This function adds a value to one of the histograms.
+ *
+ * Parameters:
+ *   hist: Histogram to add the value to.
+ *   value_ms: Value in milliseconds.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_record(app_stats_hist_t hist, uint32_t value_ms)
+{
+    log2_histogram_record(&app_stats_hist[hist], value_ms);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_get_histogram
+ ******************************************************************************
+ * Summary:
+ *   This function takes a snapshot of one of the histograms.
+ *
+ * Parameters:
+ *   hist: Histogram to take the snapshot of.
+ *   snapshot: Pointer to the histogram that receives the snapshot.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_stats_get_histogram(app_stats_hist_t hist, log2_histogram_t *snapshot)
+{
+    log2_histogram_get(&app_stats_hist[hist], snapshot);
+}
+
+/******************************************************************************
+ * Function Name: app_stats_histogram_name
+ ******************************************************************************
+ * Summary:
+ *   This function returns the name of a histogram.
+ *
+ * Parameters:
+ *   hist: Histogram.
+ *
+ * Return:
+ *   const char*: Name of the histogram.
+ *
+ *****************************************************************************/
+const char* app_stats_histogram_name(app_stats_hist_t hist)
+{
+    return (hist < APP_STATS_HIST_MAX) ? app_stats_hist_names[hist] : "unknown";
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,90 @@
+/******************************************************************************
+ * File Name: app_stats.h
+ *
+ * Description:
+ *   This is the header file and contains the type definition and function
+ *   declarations for the application counters defined in app_stats.cpp file.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef APP_STATS_H
+#define APP_STATS_H
+
+#include "mbed.h"
+#include "log2_histogram.h"
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Counters of network stack suspension and HTTP server activity since
+ * startup. They only ever increase.
+ */
+typedef struct
+{
+    uint32_t nw_suspend_attempts;   /* Calls to wait_net_suspend().            */
+    uint32_t nw_suspends;           /* Suspends that were followed by a resume. */
+    uint32_t nw_suspend_abandoned;  /* Sleep requests dropped without a suspend. */
+    uint32_t http_requests;         /* Requests served by the dynamic pages.   */
+    uint64_t http_bytes_sent;       /* Body bytes written by the dynamic pages. */
+    uint32_t http_eviction_passes;  /* Passes closing all connections.         */
+    uint32_t http_drain_timeouts;   /* Suspends with a response unacknowledged. */
+} app_stats_t;
+
+/* Distributions of the network stack suspend episodes, in milliseconds. */
+typedef enum
+{
+    APP_STATS_HIST_SLEEP_EPISODE,     /* Time the stack stayed suspended.       */
+    APP_STATS_HIST_SUSPEND_LATENCY,   /* Sleep request to stack suspended.      */
+    APP_STATS_HIST_RESUME_LATENCY,    /* Wake frame to stack resumed.           */
+    APP_STATS_HIST_MAX
+} app_stats_hist_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+void app_stats_nw_suspend_attempt(void);
+void app_stats_nw_suspended(void);
+void app_stats_nw_suspend_abandoned(void);
+void app_stats_http_request(void);
+void app_stats_http_bytes_sent(uint32_t bytes);
+void app_stats_http_eviction_pass(void);
+void app_stats_http_drain_timeout(void);
+void app_stats_get(app_stats_t *stats);
+void app_stats_record(app_stats_hist_t hist, uint32_t value_ms);
+void app_stats_get_histogram(app_stats_hist_t hist, log2_histogram_t *snapshot);
+const char* app_stats_histogram_name(app_stats_hist_t hist);
+
+#endif /* #ifndef APP_STATS_H */
+
+
+/* [] END OF FILE */
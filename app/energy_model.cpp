@@ -0,0 +1,139 @@
+/******************************************************************************
+ * File Name: energy_model.cpp
+ *
+ * Description:
+ *   This file contains the estimate of the energy used by the kit. The time
+ *   since startup is split into the power states of the PSoC 6 MCU and of
+ *   the WLAN device, and each state is weighted with its supply current set
+ *   per kit in mbed_app.json. scripts/energy_estimate.py implements the same
+ *   model for statistics recorded from /stats.json.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "energy_model.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+/* Microamperes times millivolts to millijoules per hour. */
+#define ENERGY_UA_MV_TO_MJ_PER_HOUR(ua, mv)   (((uint64_t)(ua) * (mv) * 36) / 10000)
+
+/******************************************************************************
+ *                              EXTERNS
+ *****************************************************************************/
+extern us_timestamp_t cy_dsleep_nw_suspend_time;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: energy_model_charge
+ ******************************************************************************
+ * Summary:
+ *   This function returns the share of the average current drawn in one
+ *   power state.
+ *
+ * Parameters:
+ *   current_ua: Current in microamperes drawn in the power state.
+ *   state_us: Time in microseconds spent in the power state.
+ *   uptime_us: Time in microseconds since startup.
+ *
+ * Return:
+ *   uint64_t: Share of the average current in microamperes.
+ *
+ *****************************************************************************/
+static uint64_t energy_model_charge(uint32_t current_ua, uint64_t state_us,
+                                    uint64_t uptime_us)
+{
+    return ((uint64_t)current_ua * state_us) / uptime_us;
+}
+
+/******************************************************************************
+ * Function Name: energy_model_estimate
+ ******************************************************************************
+ * Summary:
+ *   This function estimates the average supply current of the kit since
+ *   startup. The MCU is active whenever it is neither in sleep nor in deep
+ *   sleep. The WLAN device is taken as awake whenever the host network stack
+ *   is not suspended, and as in power save with ARP offload otherwise.
+ *
+ * Parameters:
+ *   estimate: Pointer to the structure that receives the estimate.
+ *
+ * Return:
+ *   bool: true if the estimate is valid, false if the MCU sleep statistics
+ *     are not enabled or no time has passed yet.
+ *
+ *****************************************************************************/
+bool energy_model_estimate(energy_estimate_t *estimate)
+{
+#if defined(MBED_CPU_STATS_ENABLED)
+    uint64_t uptime_us = mbed_uptime();
+    uint64_t sleep_us = mbed_time_sleep();
+    uint64_t deepsleep_us = mbed_time_deepsleep();
+    uint64_t suspended_us = cy_dsleep_nw_suspend_time;
+    uint64_t active_us;
+    uint64_t avg_ua;
+
+    if ((0 == uptime_us) || ((sleep_us + deepsleep_us) > uptime_us) || (suspended_us > uptime_us))
+    {
+        return false;
+    }
+    active_us = uptime_us - sleep_us - deepsleep_us;
+
+    avg_ua = energy_model_charge(MBED_CONF_APP_ENERGY_MCU_ACTIVE_UA, active_us, uptime_us) +
+             energy_model_charge(MBED_CONF_APP_ENERGY_MCU_SLEEP_UA, sleep_us, uptime_us) +
+             energy_model_charge(MBED_CONF_APP_ENERGY_MCU_DEEPSLEEP_UA, deepsleep_us, uptime_us) +
+             energy_model_charge(MBED_CONF_APP_ENERGY_WLAN_AWAKE_UA,
+                                 uptime_us - suspended_us, uptime_us) +
+             energy_model_charge(MBED_CONF_APP_ENERGY_WLAN_OFFLOAD_UA, suspended_us, uptime_us);
+    if (0 == avg_ua)
+    {
+        avg_ua = 1;
+    }
+
+    estimate->avg_current_ua     = (uint32_t)avg_ua;
+    estimate->energy_mj_per_hour = (uint32_t)ENERGY_UA_MV_TO_MJ_PER_HOUR(avg_ua,
+                                                  MBED_CONF_APP_ENERGY_SUPPLY_MV);
+    estimate->battery_life_hours = (uint32_t)(((uint64_t)MBED_CONF_APP_ENERGY_BATTERY_MAH * 1000) / avg_ua);
+
+    return true;
+#else
+    (void)estimate;
+
+    return false;
+#endif /* #if defined(MBED_CPU_STATS_ENABLED) */
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,392 @@
+/******************************************************************************
+ * File Name: host_sleep.cpp
+ *
+ * Description:
+ *   This file contains the host sleep state machine and the handoff of host
+ *   sleep requests from the HTTP server to the thread that suspends the host
+ *   network stack. The state is changed with atomic operations, so it can be
+ *   read and changed from any thread without locking.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "host_sleep.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+/* Set in host_sleep_state, next to the state, when a sleep request arrives
+ * once the search for an inactive window has started. It makes the sleep
+ * thread start a new suspend when the current one ends, instead of dropping
+ * the request.
+ */
+#define HOST_SLEEP_REQUESTED_BIT       (1UL << 31)
+
+/* Set in host_sleep_state, next to PENDING_SUSPEND, once the response to the
+ * sleep request has drained and the search for an inactive window started.
+ */
+#define HOST_SLEEP_SEARCHING_BIT       (1UL << 30)
+
+#define HOST_SLEEP_STATE_MASK          (~(HOST_SLEEP_REQUESTED_BIT | HOST_SLEEP_SEARCHING_BIT))
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Event flags that carry the sleep request to the sleep thread. */
+static EventFlags host_sleep_flags;
+
+/* Current host_sleep_state_t, with HOST_SLEEP_REQUESTED_BIT and
+ * HOST_SLEEP_SEARCHING_BIT, accessed atomically.
+ */
+static volatile uint32_t host_sleep_state = HOST_SLEEP_STATE_AWAKE;
+
+/* Time each state was last entered, in milliseconds since startup. */
+static volatile uint64_t host_sleep_entered_ms[HOST_SLEEP_STATE_MAX];
+
+/* Time the last wait_net_suspend() call returned. */
+static volatile uint64_t host_sleep_resumed_ms;
+
+/* Sleep requests merged with a suspend that was already pending or running. */
+static volatile uint32_t host_sleep_requests_coalesced;
+
+/* Suspends started by a request that arrived during the previous one. */
+static volatile uint32_t host_sleep_requests_rearmed;
+
+static const char* const host_sleep_state_names[HOST_SLEEP_STATE_MAX] = {
+    "awake",
+    "pending-suspend",
+    "suspended",
+    "resuming"
+};
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: host_sleep_record_entry
+ ******************************************************************************
+ * Summary:
+ *   This function records the time a state was entered.
+ *
+ * Parameters:
+ *   state: State that was entered.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void host_sleep_record_entry(host_sleep_state_t state)
+{
+    uint64_t now_ms = Kernel::Clock::now().time_since_epoch().count();
+
+    core_util_atomic_store_u64(&host_sleep_entered_ms[state], now_ms);
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_arm
+ ******************************************************************************
+ * Summary:
+ *   This function records the entry to PENDING_SUSPEND and wakes the sleep
+ *   thread. The caller has already moved the state machine to
+ *   PENDING_SUSPEND.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void host_sleep_arm(void)
+{
+    host_sleep_record_entry(HOST_SLEEP_STATE_PENDING_SUSPEND);
+    host_sleep_flags.set(HOST_SLEEP_REQUEST_FLAG);
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_request
+ ******************************************************************************
+ * Summary:
+ *   This function requests the host network stack to be suspended. It does
+ *   not block, and can be called from the HTTP server thread while the
+ *   response to the request is still being sent. A request made while the
+ *   response to a request drains is merged with it, so repeated requests do
+ *   not cause repeated suspend/resume cycles. A request made once the search
+ *   for an inactive window has started, for example the request whose
+ *   packet resumed the stack, is merged as well but starts a new suspend
+ *   once the current one ends.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   bool: true if a new suspend was requested, false if the request was
+ *     merged with a suspend already pending or running.
+ *
+ *****************************************************************************/
+bool host_sleep_request(void)
+{
+    uint32_t state = core_util_atomic_load_u32(&host_sleep_state);
+
+    do
+    {
+        if (HOST_SLEEP_STATE_AWAKE == state)
+        {
+            if (core_util_atomic_cas_u32(&host_sleep_state, &state, HOST_SLEEP_STATE_PENDING_SUSPEND))
+            {
+                host_sleep_arm();
+                return true;
+            }
+        }
+        else if ((HOST_SLEEP_STATE_PENDING_SUSPEND == state) ||
+                 (0 != (state & HOST_SLEEP_REQUESTED_BIT)))
+        {
+            /* Draining, or a new suspend is already requested. */
+            break;
+        }
+        else if (core_util_atomic_cas_u32(&host_sleep_state, &state,
+                                          state | HOST_SLEEP_REQUESTED_BIT))
+        {
+            break;
+        }
+    } while (1);
+
+    core_util_atomic_incr_u32(&host_sleep_requests_coalesced, 1);
+
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_wait_request
+ ******************************************************************************
+ * Summary:
+ *   This function waits for a sleep request. The sleep thread then drains
+ *   the response to the request before it suspends the network stack.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void host_sleep_wait_request(void)
+{
+    host_sleep_flags.wait_any(HOST_SLEEP_REQUEST_FLAG);
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_searching
+ ******************************************************************************
+ * Summary:
+ *   This function marks the end of the drain. It is called by the sleep
+ *   thread just before it starts to look for an inactive window with
+ *   wait_net_suspend(). The state machine stays in PENDING_SUSPEND, but a
+ *   sleep request made from now on starts a new suspend.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void host_sleep_searching(void)
+{
+    core_util_atomic_store_u32(&host_sleep_state,
+                               HOST_SLEEP_STATE_PENDING_SUSPEND | HOST_SLEEP_SEARCHING_BIT);
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_resuming
+ ******************************************************************************
+ * Summary:
+ *   This function moves the state machine from the search for an inactive
+ *   window through SUSPENDED to RESUMING. It is called from the input path
+ *   of the lwIP interface when the frame that resumed the stack arrives, so
+ *   the state is RESUMING while that frame is handled, before the sleep
+ *   thread returns from wait_net_suspend(). The LPA does not report the
+ *   suspend while it happens, and the state cannot be read over the network
+ *   while the stack is suspended, so SUSPENDED is only recorded with the
+ *   time it began.
+ *
+ * Parameters:
+ *   suspend_ms: Time the stack was suspended, in milliseconds since
+ *     startup.
+ *   wake_ms: Time of the frame that resumed the stack.
+ *
+ * Return:
+ *   bool: true if the state machine moved to RESUMING, false if it was not
+ *     searching for an inactive window.
+ *
+ *****************************************************************************/
+bool host_sleep_resuming(uint64_t suspend_ms, uint64_t wake_ms)
+{
+    uint32_t state = core_util_atomic_load_u32(&host_sleep_state);
+
+    do
+    {
+        if ((HOST_SLEEP_STATE_PENDING_SUSPEND | HOST_SLEEP_SEARCHING_BIT) !=
+            (state & ~HOST_SLEEP_REQUESTED_BIT))
+        {
+            return false;
+        }
+    } while (!core_util_atomic_cas_u32(&host_sleep_state, &state,
+                                       (state & HOST_SLEEP_REQUESTED_BIT) |
+                                       HOST_SLEEP_STATE_RESUMING));
+
+    core_util_atomic_store_u64(&host_sleep_entered_ms[HOST_SLEEP_STATE_SUSPENDED], suspend_ms);
+    core_util_atomic_store_u64(&host_sleep_entered_ms[HOST_SLEEP_STATE_RESUMING], wake_ms);
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_suspended
+ ******************************************************************************
+ * Summary:
+ *   This function records a suspend of the network stack. It is called by
+ *   the sleep thread when wait_net_suspend() returns after the LPA suspended
+ *   the stack. If the frame that resumed the stack already moved the state
+ *   machine to RESUMING, only the time of the suspend, which the sleep
+ *   thread knows better, is updated. A resume without a frame moves the
+ *   state machine to RESUMING here.
+ *
+ * Parameters:
+ *   suspend_ms: Time the stack was suspended, in milliseconds since
+ *     startup.
+ *   wake_ms: Time of the frame that resumed the stack, or of the resume if
+ *     there was none.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void host_sleep_suspended(uint64_t suspend_ms, uint64_t wake_ms)
+{
+    if (!host_sleep_resuming(suspend_ms, wake_ms))
+    {
+        core_util_atomic_store_u64(&host_sleep_entered_ms[HOST_SLEEP_STATE_SUSPENDED], suspend_ms);
+    }
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_resumed
+ ******************************************************************************
+ * Summary:
+ *   This function ends a suspend cycle. It is called by the sleep thread
+ *   once it has handled the resume, in RESUMING, or once the sleep request
+ *   is dropped without a suspend, in PENDING_SUSPEND. If a sleep request
+ *   arrived once the search had started, the state machine moves back to
+ *   PENDING_SUSPEND and the sleep thread is woken again; otherwise it moves
+ *   to AWAKE.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   bool: true if a new suspend was started for a request that arrived
+ *     during the cycle.
+ *
+ *****************************************************************************/
+bool host_sleep_resumed(void)
+{
+    uint32_t state = core_util_atomic_load_u32(&host_sleep_state);
+    uint32_t next;
+
+    core_util_atomic_store_u64(&host_sleep_resumed_ms,
+                               Kernel::Clock::now().time_since_epoch().count());
+
+    do
+    {
+        next = (0 != (state & HOST_SLEEP_REQUESTED_BIT)) ?
+               HOST_SLEEP_STATE_PENDING_SUSPEND : HOST_SLEEP_STATE_AWAKE;
+    } while (!core_util_atomic_cas_u32(&host_sleep_state, &state, next));
+
+    if (HOST_SLEEP_STATE_AWAKE == next)
+    {
+        host_sleep_record_entry(HOST_SLEEP_STATE_AWAKE);
+        return false;
+    }
+
+    core_util_atomic_incr_u32(&host_sleep_requests_rearmed, 1);
+    host_sleep_arm();
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_get_info
+ ******************************************************************************
+ * Summary:
+ *   This function takes a snapshot of the state machine.
+ *
+ * Parameters:
+ *   info: Pointer to the structure that receives the snapshot.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void host_sleep_get_info(host_sleep_info_t *info)
+{
+    info->state = (host_sleep_state_t)(core_util_atomic_load_u32(&host_sleep_state) &
+                                       HOST_SLEEP_STATE_MASK);
+    for (uint32_t i = 0; i < HOST_SLEEP_STATE_MAX; i++)
+    {
+        info->entered_ms[i] = core_util_atomic_load_u64(&host_sleep_entered_ms[i]);
+    }
+    info->resumed_ms = core_util_atomic_load_u64(&host_sleep_resumed_ms);
+    info->requests_coalesced = core_util_atomic_load_u32(&host_sleep_requests_coalesced);
+    info->requests_rearmed = core_util_atomic_load_u32(&host_sleep_requests_rearmed);
+}
+
+/******************************************************************************
+ * Function Name: host_sleep_state_name
+ ******************************************************************************
+ * Summary:
+ *   This function returns the name of a state.
+ *
+ * Parameters:
+ *   state: State of the state machine.
+ *
+ * Return:
+ *   const char*: Name of the state.
+ *
+ *****************************************************************************/
+const char* host_sleep_state_name(host_sleep_state_t state)
+{
+    return (state < HOST_SLEEP_STATE_MAX) ? host_sleep_state_names[state] : "unknown";
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * File Name: host_sleep.h
+ *
+ * Description:
+ *   This is the header file and contains the macro definitions and function
+ *   declarations for the host sleep request handling defined in
+ *   host_sleep.cpp file.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_SLEEP_H
+#define HOST_SLEEP_H
+
+#include "mbed.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+#define HOST_SLEEP_REQUEST_FLAG        (1UL << 0)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* States of the host sleep state machine:
+ *   AWAKE           -> PENDING_SUSPEND on a sleep request.
+ *   PENDING_SUSPEND -> SUSPENDED when the LPA suspends the network stack, or
+ *                   -> AWAKE if the sleep request is dropped without one.
+ *   SUSPENDED       -> RESUMING at the frame that resumes the stack, or when
+ *                      the sleep thread finds the stack resumed without one.
+ *   RESUMING        -> AWAKE once the sleep thread has handled the resume.
+ * PENDING_SUSPEND covers the drain of the response to the request and the
+ * search for an inactive window, with the stack up. A sleep request that
+ * arrives once the search has started moves the state machine back to
+ * PENDING_SUSPEND instead of AWAKE at the end of the suspend.
+ */
+typedef enum
+{
+    HOST_SLEEP_STATE_AWAKE,
+    HOST_SLEEP_STATE_PENDING_SUSPEND,
+    HOST_SLEEP_STATE_SUSPENDED,
+    HOST_SLEEP_STATE_RESUMING,
+    HOST_SLEEP_STATE_MAX
+} host_sleep_state_t;
+
+/* Snapshot of the host sleep state machine. Times are in milliseconds since
+ * startup; a state that was never entered has a time of 0. 'resumed_ms' is
+ * the time the last suspend cycle ended.
+ */
+typedef struct
+{
+    host_sleep_state_t state;
+    uint64_t           entered_ms[HOST_SLEEP_STATE_MAX];
+    uint64_t           resumed_ms;
+    uint32_t           requests_coalesced;
+    uint32_t           requests_rearmed;
+} host_sleep_info_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+bool host_sleep_request(void);
+void host_sleep_wait_request(void);
+void host_sleep_searching(void);
+bool host_sleep_resuming(uint64_t suspend_ms, uint64_t wake_ms);
+void host_sleep_suspended(uint64_t suspend_ms, uint64_t wake_ms);
+bool host_sleep_resumed(void);
+void host_sleep_get_info(host_sleep_info_t *info);
+const char* host_sleep_state_name(host_sleep_state_t state);
+
+#endif /* #ifndef HOST_SLEEP_H */
+
+
+/* [] END OF FILE */
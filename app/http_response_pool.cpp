@@ -0,0 +1,229 @@
+/******************************************************************************
+ * File Name: http_response_pool.cpp
+ *
+ * Description:
+ *   This file contains the fixed pool of HTTP response buffers, and the peak
+ *   RAM usage of the dynamic pages. A page that builds its whole response
+ *   before sending it takes a buffer from the pool for the duration of a
+ *   request, so that requests served in parallel on different connections
+ *   do not share the same response buffer. Pages that stream their response
+ *   through a stack chunk only report how much of the chunk they used.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "http_response_pool.h"
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Pool of response buffers shared by the dynamic page handlers. */
+static MemoryPool<http_response_buf_t, HTTP_RESPONSE_POOL_SIZE> response_pool;
+
+/* Usage of the pool, accessed atomically. */
+static http_response_pool_stats_t response_pool_stats;
+
+static const char* const http_response_page_names[HTTP_RESPONSE_PAGE_MAX] = {
+    "/stats",
+    "/stats.json",
+    "/metrics"
+};
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: http_response_pool_update_peak
+ ******************************************************************************
+ * Summary:
+ *   This function raises a peak value to the given value if it is higher.
+ *
+ * Parameters:
+ *   peak: Pointer to the peak value.
+ *   value: New value.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void http_response_pool_update_peak(volatile uint32_t *peak, uint32_t value)
+{
+    uint32_t current = core_util_atomic_load_u32(peak);
+
+    while ((value > current) && !core_util_atomic_cas_u32(peak, &current, value))
+    {
+    }
+}
+
+/******************************************************************************
+ * Function Name: http_response_buf_alloc
+ ******************************************************************************
+ * Summary:
+ *   This function takes a free response buffer from the pool. The buffer is
+ *   owned by the caller until it is returned with http_response_buf_free().
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   http_response_buf_t*: Pointer to the response buffer, or NULL if all the
+ *     buffers in the pool are in use.
+ *
+ *****************************************************************************/
+http_response_buf_t* http_response_buf_alloc(void)
+{
+    http_response_buf_t *buf = response_pool.try_alloc();
+
+    if (NULL == buf)
+    {
+        core_util_atomic_incr_u32(&response_pool_stats.alloc_failures, 1);
+        ERR_INFO(("No free HTTP response buffer\r\n"));
+    }
+    else
+    {
+        http_response_pool_update_peak(&response_pool_stats.peak_in_use,
+                                       core_util_atomic_incr_u32(&response_pool_stats.in_use, 1));
+    }
+
+    return buf;
+}
+
+/******************************************************************************
+ * Function Name: http_response_buf_free
+ ******************************************************************************
+ * Summary:
+ *   This function returns a response buffer to the pool.
+ *
+ * Parameters:
+ *   buf: Pointer to the response buffer taken with http_response_buf_alloc().
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_response_buf_free(http_response_buf_t *buf)
+{
+    if (NULL != buf)
+    {
+        core_util_atomic_decr_u32(&response_pool_stats.in_use, 1);
+        response_pool.free(buf);
+    }
+}
+
+/******************************************************************************
+ * Function Name: http_response_buf_used
+ ******************************************************************************
+ * Summary:
+ *   This function records how many bytes of a response buffer a page took,
+ *   for the peak usage of the pool and of the page.
+ *
+ * Parameters:
+ *   page: Page that built its response in the buffer.
+ *   bytes: Number of bytes of the buffer used by the response.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_response_buf_used(http_response_page_t page, uint32_t bytes)
+{
+    http_response_pool_update_peak(&response_pool_stats.peak_bytes, bytes);
+    http_response_pool_update_peak(&response_pool_stats.page_peak_bytes[page], bytes);
+}
+
+/******************************************************************************
+ * Function Name: http_response_chunk_used
+ ******************************************************************************
+ * Summary:
+ *   This function records the most bytes of its stream buffer chunk a page
+ *   filled before a flush, for the peak usage of the chunks and of the page.
+ *
+ * Parameters:
+ *   page: Page that streamed its response through the chunk.
+ *   bytes: Most bytes of the chunk used at one time.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_response_chunk_used(http_response_page_t page, uint32_t bytes)
+{
+    http_response_pool_update_peak(&response_pool_stats.peak_chunk_bytes, bytes);
+    http_response_pool_update_peak(&response_pool_stats.page_peak_bytes[page], bytes);
+}
+
+/******************************************************************************
+ * Function Name: http_response_pool_get_stats
+ ******************************************************************************
+ * Summary:
+ *   This function takes a snapshot of the usage of the pool.
+ *
+ * Parameters:
+ *   stats: Pointer to the structure that receives the usage.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_response_pool_get_stats(http_response_pool_stats_t *stats)
+{
+    stats->in_use           = core_util_atomic_load_u32(&response_pool_stats.in_use);
+    stats->peak_in_use      = core_util_atomic_load_u32(&response_pool_stats.peak_in_use);
+    stats->peak_bytes       = core_util_atomic_load_u32(&response_pool_stats.peak_bytes);
+    stats->peak_chunk_bytes = core_util_atomic_load_u32(&response_pool_stats.peak_chunk_bytes);
+    stats->alloc_failures   = core_util_atomic_load_u32(&response_pool_stats.alloc_failures);
+    for (uint32_t i = 0; i < HTTP_RESPONSE_PAGE_MAX; i++)
+    {
+        stats->page_peak_bytes[i] = core_util_atomic_load_u32(&response_pool_stats.page_peak_bytes[i]);
+    }
+}
+
+/******************************************************************************
+ * Function Name: http_response_page_name
+ ******************************************************************************
+ * Summary:
+ *   This function returns the URL of a page tracked by the pool statistics.
+ *
+ * Parameters:
+ *   page: Page of the pool statistics.
+ *
+ * Return:
+ *   const char*: URL of the page.
+ *
+ *****************************************************************************/
+const char* http_response_page_name(http_response_page_t page)
+{
+    return (page < HTTP_RESPONSE_PAGE_MAX) ? http_response_page_names[page] : "unknown";
+}
+
+
+/* [] END OF FILE */
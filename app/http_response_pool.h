@@ -0,0 +1,103 @@
+/******************************************************************************
+ * File Name: http_response_pool.h
+ *
+ * Description:
+ *   This is the header file and contains the type definition and function
+ *   declarations for the HTTP response buffer pool defined in
+ *   http_response_pool.cpp file.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HTTP_RESPONSE_POOL_H
+#define HTTP_RESPONSE_POOL_H
+
+#include "mbed.h"
+#include "http_webserver_config.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+/* One response buffer for every connection the HTTP server can serve at the
+ * same time. The pool never grows beyond this bound.
+ */
+#define HTTP_RESPONSE_POOL_SIZE  (MAX_SOCKETS)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+typedef struct
+{
+    char data[HTTP_BYTES_LEN];
+} http_response_buf_t;
+
+/* Dynamic pages that build their response in RAM: /stats.json in a buffer
+ * of the pool, /stats and /metrics in a stream buffer chunk of
+ * HTTP_STREAM_CHUNK_LEN bytes on the stack. The other pages are sent from
+ * flash.
+ */
+typedef enum
+{
+    HTTP_RESPONSE_PAGE_STATS,
+    HTTP_RESPONSE_PAGE_STATS_JSON,
+    HTTP_RESPONSE_PAGE_METRICS,
+    HTTP_RESPONSE_PAGE_MAX
+} http_response_page_t;
+
+/* Usage of the response pool and the stream buffer chunks since startup, to
+ * size HTTP_BYTES_LEN, HTTP_STREAM_CHUNK_LEN and HTTP_RESPONSE_POOL_SIZE
+ * from measured data.
+ */
+typedef struct
+{
+    uint32_t in_use;            /* Buffers currently taken.                */
+    uint32_t peak_in_use;       /* Most buffers taken at the same time.    */
+    uint32_t peak_bytes;        /* Most bytes used in a single buffer.     */
+    uint32_t peak_chunk_bytes;  /* Most bytes used in a stream buffer chunk. */
+    uint32_t alloc_failures;    /* Allocations that found no free buffer.  */
+    uint32_t page_peak_bytes[HTTP_RESPONSE_PAGE_MAX]; /* Most bytes per page. */
+} http_response_pool_stats_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+http_response_buf_t* http_response_buf_alloc(void);
+void http_response_buf_used(http_response_page_t page, uint32_t bytes);
+void http_response_chunk_used(http_response_page_t page, uint32_t bytes);
+void http_response_buf_free(http_response_buf_t *buf);
+void http_response_pool_get_stats(http_response_pool_stats_t *stats);
+const char* http_response_page_name(http_response_page_t page);
+
+#endif /* #ifndef HTTP_RESPONSE_POOL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,292 @@
+/******************************************************************************
+ * File Name: http_response_writer.cpp
+ *
+ * Description:
+ *   This file contains helpers that write HTTP responses to the response
+ *   stream of the HTTP server.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "http_response_writer.h"
+#include "num_to_str.h"
+#include "app_stats.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+/* Longest number written by http_stream_buf_write_usec(): all the digits of
+ * UINT64_MAX seconds, the decimal point and six decimals.
+ */
+#define MAX_NUM_STR_LEN          (UINT64_MAX_DIGITS + 7u)
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: http_response_stream_writev
+ ******************************************************************************
+ * Summary:
+ *   This function writes a list of fragments to the HTTP response stream in
+ *   order, without gathering them into a single buffer first. Each fragment
+ *   is handed to the stream where it lies, so static page text is sent
+ *   directly from flash. The TCP stream of the HTTP server packs the
+ *   written data into its transmit packet and sends it once a full segment
+ *   is assembled or the response is flushed, so several small fragments do
+ *   not result in several small segments.
+ *
+ * Parameters:
+ *   server: Pointer to the HTTP server object that owns the stream.
+ *   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+ *   iov: Array of fragments to write.
+ *   iov_count: Number of entries in iov.
+ *
+ * Return:
+ *   cy_rslt_t: Returns error code as defined in cy_rslt_t.
+ *
+ *****************************************************************************/
+cy_rslt_t http_response_stream_writev(HTTPServer *server,
+                                      cy_http_response_stream_t* stream,
+                                      const http_iovec_t *iov,
+                                      uint32_t iov_count)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if ((NULL == server) || (NULL == stream) || ((NULL == iov) && (0 != iov_count)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (uint32_t i = 0; (i < iov_count) && (CY_RSLT_SUCCESS == result); i++)
+    {
+        /* Empty fragments would only add framing when chunked transfer
+         * encoding is in use.
+         */
+        if (0 == iov[i].length)
+        {
+            continue;
+        }
+
+        result = server->http_response_stream_write(stream, iov[i].base, iov[i].length);
+        if (CY_RSLT_SUCCESS == result)
+        {
+            app_stats_http_bytes_sent(iov[i].length);
+        }
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: http_stream_buf_init
+ ******************************************************************************
+ * Summary:
+ *   This function prepares a stream buffer in front of an HTTP response
+ *   stream.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer.
+ *   server: Pointer to the HTTP server object that owns the stream.
+ *   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+ *   buf: Buffer used to collect output.
+ *   size: Size of the buffer in bytes. Must be at least MAX_NUM_STR_LEN.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_stream_buf_init(http_stream_buf_t *sb,
+                          HTTPServer *server,
+                          cy_http_response_stream_t* stream,
+                          char *buf,
+                          uint32_t size)
+{
+    sb->server      = server;
+    sb->stream      = stream;
+    sb->buf         = buf;
+    sb->size        = size;
+    sb->length      = 0;
+    sb->peak_length = 0;
+    sb->result      = ((NULL == buf) || (size < MAX_NUM_STR_LEN)) ? CY_RSLT_TYPE_ERROR : CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: http_stream_buf_flush
+ ******************************************************************************
+ * Summary:
+ *   This function writes the output collected in the stream buffer to the
+ *   response stream.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer.
+ *
+ * Return:
+ *   cy_rslt_t: Returns the first error met by the stream buffer, or
+ *     CY_RSLT_SUCCESS.
+ *
+ *****************************************************************************/
+cy_rslt_t http_stream_buf_flush(http_stream_buf_t *sb)
+{
+    http_iovec_t iov = { sb->buf, sb->length };
+
+    if (sb->length > sb->peak_length)
+    {
+        sb->peak_length = sb->length;
+    }
+
+    if ((CY_RSLT_SUCCESS == sb->result) && (0 != sb->length))
+    {
+        sb->result = http_response_stream_writev(sb->server, sb->stream, &iov, 1);
+    }
+    sb->length = 0;
+
+    return sb->result;
+}
+
+/******************************************************************************
+ * Function Name: http_stream_buf_write
+ ******************************************************************************
+ * Summary:
+ *   This function adds data to the stream buffer, writing the buffer to the
+ *   response stream each time it fills up.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer.
+ *   data: Data to write.
+ *   length: Length of the data in bytes.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_stream_buf_write(http_stream_buf_t *sb, const char *data, uint32_t length)
+{
+    uint32_t copy_len = 0;
+
+    while ((CY_RSLT_SUCCESS == sb->result) && (0 != length))
+    {
+        copy_len = sb->size - sb->length;
+        if (copy_len > length)
+        {
+            copy_len = length;
+        }
+
+        memcpy(&sb->buf[sb->length], data, copy_len);
+        sb->length += copy_len;
+        data       += copy_len;
+        length     -= copy_len;
+
+        if (sb->length == sb->size)
+        {
+            http_stream_buf_flush(sb);
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: http_stream_buf_write_str
+ ******************************************************************************
+ * Summary:
+ *   This function adds a NUL terminated string to the stream buffer.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer.
+ *   str: String to write.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_stream_buf_write_str(http_stream_buf_t *sb, const char *str)
+{
+    http_stream_buf_write(sb, str, strlen(str));
+}
+
+/******************************************************************************
+ * Function Name: http_stream_buf_write_uint64
+ ******************************************************************************
+ * Summary:
+ *   This function adds the decimal representation of an unsigned integer to
+ *   the stream buffer.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer.
+ *   value: Value to write.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_stream_buf_write_uint64(http_stream_buf_t *sb, uint64_t value)
+{
+    if ((sb->size - sb->length) < MAX_NUM_STR_LEN)
+    {
+        http_stream_buf_flush(sb);
+    }
+
+    if (CY_RSLT_SUCCESS == sb->result)
+    {
+        sb->length += uint64_to_str(value, &sb->buf[sb->length], sb->size - sb->length);
+    }
+}
+
+/******************************************************************************
+ * Function Name: http_stream_buf_write_usec
+ ******************************************************************************
+ * Summary:
+ *   This function adds a time in microseconds to the stream buffer, written
+ *   as seconds with six decimals.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer.
+ *   usec: Time in microseconds.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_stream_buf_write_usec(http_stream_buf_t *sb, uint64_t usec)
+{
+    if ((sb->size - sb->length) < MAX_NUM_STR_LEN)
+    {
+        http_stream_buf_flush(sb);
+    }
+
+    if (CY_RSLT_SUCCESS == sb->result)
+    {
+        sb->length += usec_to_sec_str(usec, &sb->buf[sb->length], sb->size - sb->length);
+    }
+}
+
+
+/* [] END OF FILE */
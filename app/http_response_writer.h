@@ -0,0 +1,100 @@
+/******************************************************************************
+ * File Name: http_response_writer.h
+ *
+ * Description:
+ *   This is the header file and contains the type definitions and function
+ *   declarations for the HTTP response writer defined in
+ *   http_response_writer.cpp file.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HTTP_RESPONSE_WRITER_H
+#define HTTP_RESPONSE_WRITER_H
+
+#include "mbed.h"
+#include "HTTP_server.hpp"
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* One fragment of an HTTP response: pointer and length of data that is sent
+ * as is, without being copied into a response buffer first.
+ */
+typedef struct
+{
+    const void *base;
+    uint32_t    length;
+} http_iovec_t;
+
+/* Fixed-size buffer in front of a response stream. Output is collected in
+ * the buffer and written to the stream each time the buffer fills up, so a
+ * response of any length can be produced with a small buffer. The HTTP
+ * server sends dynamic content with chunked transfer encoding, so every
+ * flush goes out as one chunk and the total length never has to be known
+ * up front. The first write error is kept in 'result' and stops further
+ * output. 'peak_length' is the most bytes the buffer held before a flush.
+ */
+typedef struct
+{
+    HTTPServer                *server;
+    cy_http_response_stream_t *stream;
+    char                      *buf;
+    uint32_t                   size;
+    uint32_t                   length;
+    uint32_t                   peak_length;
+    cy_rslt_t                  result;
+} http_stream_buf_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+cy_rslt_t http_response_stream_writev(HTTPServer *server,
+                                      cy_http_response_stream_t* stream,
+                                      const http_iovec_t *iov,
+                                      uint32_t iov_count);
+
+void http_stream_buf_init(http_stream_buf_t *sb,
+                          HTTPServer *server,
+                          cy_http_response_stream_t* stream,
+                          char *buf,
+                          uint32_t size);
+void http_stream_buf_write(http_stream_buf_t *sb, const char *data, uint32_t length);
+void http_stream_buf_write_str(http_stream_buf_t *sb, const char *str);
+void http_stream_buf_write_uint64(http_stream_buf_t *sb, uint64_t value);
+void http_stream_buf_write_usec(http_stream_buf_t *sb, uint64_t usec);
+cy_rslt_t http_stream_buf_flush(http_stream_buf_t *sb);
+
+#endif /* #ifndef HTTP_RESPONSE_WRITER_H */
+
+
+/* [] END OF FILE */
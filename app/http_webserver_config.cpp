@@ -39,12 +39,80 @@
 
 #include <string.h>
 #include "http_webserver_config.h"
+#include "http_response_pool.h"
+#include "json_writer.h"
+#include "app_stats.h"
+#include "host_sleep.h"
+#include "nw_inactivity.h"
+#include "wake_reason.h"
+#include "energy_model.h"
 #include "WhdSTAInterface.h"
+#include "lwip/tcp.h"
+#include "lwip/api.h"
+#include "lwip/tcpip.h"
+#include "lwip/priv/tcp_priv.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+/* Upper-bound estimate of the RAM taken by each HTTP connection: its
+ * response buffer, the lwIP netconn and TCP control block, and a full TCP
+ * send buffer and receive window. lwIP allocates the send and receive data
+ * from shared pbuf pools as it is queued, so a connection only takes this
+ * much while both its buffer and its window are full. The HTTP server thread
+ * is shared by all connections and is not included.
+ */
+#define HTTP_SOCKET_RESPONSE_RAM (sizeof(http_response_buf_t))
+#define HTTP_SOCKET_LWIP_RAM     (sizeof(struct netconn) + sizeof(struct tcp_pcb) + \
+                                  TCP_SND_BUF + TCP_WND)
+#define HTTP_SOCKET_RAM          (HTTP_SOCKET_RESPONSE_RAM + HTTP_SOCKET_LWIP_RAM)
+
+/* Sockets the HTTP server opens in lwIP: one per connection and the
+ * listening socket.
+ */
+#define HTTP_LWIP_SOCKETS        (MAX_SOCKETS + 1)
+
+/* Content type of the OpenMetrics text format. Scrapers parse a body sent
+ * as text/plain with the older Prometheus text format rules, which do not
+ * allow the '# EOF' line or the UNIT metadata.
+ */
+#define METRICS_MIME_TYPE        "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+MBED_STATIC_ASSERT((MAX_SOCKETS > 0),
+                   "http-max-sockets in mbed_app.json must be at least 1");
+MBED_STATIC_ASSERT(((MAX_SOCKETS * HTTP_SOCKET_RAM) <= MBED_CONF_APP_HTTP_RAM_BUDGET),
+                   "http-max-sockets in mbed_app.json exceeds http-ram-budget");
+MBED_STATIC_ASSERT((HTTP_LWIP_SOCKETS <= MBED_CONF_LWIP_TCP_SOCKET_MAX),
+                   "http-max-sockets in mbed_app.json exceeds lwip.tcp-socket-max - 1");
+MBED_STATIC_ASSERT((HTTP_LWIP_SOCKETS <= MBED_CONF_LWIP_SOCKET_MAX),
+                   "http-max-sockets in mbed_app.json exceeds lwip.socket-max - 1");
+
+/* http_responses_pending() walks the TCP control blocks from the sleep
+ * thread. Without core locking LOCK_TCPIP_CORE() does nothing, and the
+ * tcpip thread could free a control block while it is being read.
+ */
+MBED_STATIC_ASSERT((0 != LWIP_TCPIP_CORE_LOCKING),
+                   "http_responses_pending() needs LWIP_TCPIP_CORE_LOCKING");
+
+/* Headers of the home page response. The page must not be cached: loading
+ * it is how a user wakes the host, so every load has to reach the kit. The
+ * HTTP server library does not pass If-None-Match to the application, so
+ * there is no ETag to revalidate against. Update HOME_PAGE_BODY_LEN, left
+ * without parentheses so that it can be stringified, when the page changes.
+ */
+#define HOME_PAGE_BODY_LEN       1198
+#define HOME_PAGE_HEAD           "HTTP/1.1 200 OK\r\n"                                          \
+                                 "Content-Type: text/html\r\n"                                  \
+                                 "Content-Length: " MBED_STRINGIFY(HOME_PAGE_BODY_LEN) "\r\n"   \
+                                 "Cache-Control: no-cache\r\n"                                  \
+                                 "\r\n"
 
 /******************************************************************************
  *                             GLOBALS
  *****************************************************************************/
-static char startup_response[] =
+/* Complete HTTP response of the home page. */
+static const char home_page_response[] =
+HOME_PAGE_HEAD
 "<html><head><title>Hello from mbed</title></head>"
    "<script>"
        "function host_in_sleep()"
@@ -76,44 +144,131 @@ static char startup_response[] =
    "</body>"
 "</html>";
 
-static char sleep_stats_response1[] =
+
+MBED_STATIC_ASSERT(((sizeof(home_page_response) - sizeof(HOME_PAGE_HEAD)) == HOME_PAGE_BODY_LEN),
+                   "HOME_PAGE_BODY_LEN does not match the home page");
+
+static const char sleep_stats_response1[] =
 "<html><head><title>Hello from mbed</title></head>"
    "<body><h1>Host MCU sleep stats</h1>"
        "<textarea readonly rows=\"4\" cols=\"50\" style=\"font-size:"
        "large; color: rgb(11, 11, 11); background-color: rgb(232, 221, 238);"
        "width: 450px; height: 180px;\">";
 
-static char sleep_stats_response2[] =
+static const char sleep_stats_response2[] =
        "</textarea></body></html>";
 
-static char wake_host_str1[] =
+static const char wake_host_str1[] =
 "<html>"
    "<head><title>ARP OL - Wake Host</title>"
        "<meta http-equiv=\"refresh\" content=\"0; url=http://";
 
-static char wake_host_str2[] = "\"/></head><body><p>Waking Host</p></body></html>";
+static const char wake_host_str2[] = "\"/></head><body><p>Waking Host</p></body></html>";
+
+static const char create_wake_button1[] =
+"<html>"
+   "<body>"
+       "<form action=\"/wake\" method=\"post\">"
+           "<a href=\"http://";
+
+static const char create_wake_button2[] =
+           "\">Wake Host</a>"
+           "<br><br>"
+           "<b>Note</b>: <i>This link will redirect to the main webpage. "
+           "It causes network activity and will wake the host if it is sleeping "
+           "and resumes network stack if it was suspended.</i>"
+       "</form>"
+   "</body>"
+"</html>";
+
+/* Page templates for the dynamic resources. Only the slot between the head
+ * and the tail (IP address or sleep statistics) is generated per request.
+ */
+static const http_page_template_t sleep_page = {
+    HTTP_PAGE_FRAGMENT(create_wake_button1),
+    HTTP_PAGE_FRAGMENT(create_wake_button2)
+};
 
-static char http_app_response[HTTP_BYTES_LEN] = {0};
+static const http_page_template_t wake_page = {
+    HTTP_PAGE_FRAGMENT(wake_host_str1),
+    HTTP_PAGE_FRAGMENT(wake_host_str2)
+};
+
+static const http_page_template_t stats_page = {
+    HTTP_PAGE_FRAGMENT(sleep_stats_response1),
+    HTTP_PAGE_FRAGMENT(sleep_stats_response2)
+};
 
 /* HTTP server object handle. */
 HTTPServer *server;
 
 /* HTML resources to register with the HTTP server. */
-cy_resource_static_data_t  test_data            = {startup_response, sizeof(startup_response) - 1};
+cy_resource_static_data_t  http_data_home_url   = {home_page_response, sizeof(home_page_response) - 1};
 cy_resource_dynamic_data_t http_data_sleep_url  = {host_sleep_pageload, NULL};
 cy_resource_dynamic_data_t http_data_stats_url  = {sleep_stats_pageload, NULL};
 cy_resource_dynamic_data_t http_data_wake_url   = {host_wake_pageload, NULL};
+cy_resource_dynamic_data_t http_data_stats_json_url = {sleep_stats_json_pageload, NULL};
+cy_resource_dynamic_data_t http_data_metrics_url    = {metrics_pageload, NULL};
+
+/* Resources served by the HTTP server. The HTTP server looks up a request
+ * by comparing its URL against the resources in registration order, so the
+ * resources polled by monitoring tools come first. The home page is a
+ * complete HTTP response with its own Cache-Control header, so it is
+ * registered as raw static content and the server sends it from flash
+ * unchanged. Like any other frame, the request wakes the host whether or
+ * not a handler runs for it.
+ */
+static const app_http_route_t http_routes[] = {
+    { "/metrics",    METRICS_MIME_TYPE,  CY_DYNAMIC_URL_CONTENT,    &http_data_metrics_url    },
+    { "/stats.json", "application/json", CY_DYNAMIC_URL_CONTENT,    &http_data_stats_json_url },
+    { "/",           "text/html",        CY_RAW_STATIC_URL_CONTENT, &http_data_home_url       },
+    { "/stats",      "text/html",        CY_DYNAMIC_URL_CONTENT,    &http_data_stats_url      },
+    { "/sleep",      "text/html",        CY_DYNAMIC_URL_CONTENT,    &http_data_sleep_url      },
+    { "/wake",       "text/html",        CY_DYNAMIC_URL_CONTENT,    &http_data_wake_url       },
+};
 
 /******************************************************************************
  *                              EXTERNS
  *****************************************************************************/
-extern Semaphore  request_host_sleep_sema;
 extern us_timestamp_t cy_dsleep_nw_suspend_time;
 extern WhdSTAInterface *wifi;
 
 /******************************************************************************
  *                        FUNCTION DEFINITIONS
  *****************************************************************************/
+/******************************************************************************
+ * Function Name: http_page_write
+ ******************************************************************************
+ * Summary:
+ *   This function sends a page built from a template. The static head, the
+ *   dynamic slot, and the static tail are written with one stream write
+ *   each, so the head and tail are sent directly from flash instead of being
+ *   copied into a response buffer first.
+ *
+ * Parameters:
+ *   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+ *   page: Pointer to the page template.
+ *   slot: Dynamic content to place between the head and the tail.
+ *   slot_len: Length of the dynamic content in bytes.
+ *
+ * Return:
+ *   cy_rslt_t: Returns error code as defined in cy_rslt_t.
+ *
+ *****************************************************************************/
+static cy_rslt_t http_page_write(cy_http_response_stream_t* stream,
+                                 const http_page_template_t* page,
+                                 const char* slot,
+                                 uint32_t slot_len)
+{
+    const http_iovec_t iov[] = {
+        page->head,
+        { slot, slot_len },
+        page->tail
+    };
+
+    return http_response_stream_writev(server, stream, iov, sizeof(iov) / sizeof(iov[0]));
+}
+
 /******************************************************************************
  * Function Name: http_sleep_pageload
  ******************************************************************************
@@ -142,49 +297,32 @@ int32_t host_sleep_pageload(const char* url_path,
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
     SocketAddress sock_addr;
+    const char *ip_addr = NULL;
 
-    char create_wake_button1[] = "<html>"
-                                 "<body>"
-                                     "<form action=\"/wake\" method=\"post\">"
-                                         "<a href=\"http://";
-
-    char create_wake_button2[] =             "\">Wake Host</a>"
-                                         "<br><br>"
-                                         "<b>Note</b>: <i>This link will redirect to the main webpage. "
-                                         "It causes network activity and will wake the host if it is sleeping "
-                                         "and resumes network stack if it was suspended.</i>"
-                                     "</form>"
-                                 "</body>"
-                                 "</html>";
-    uint32_t data_len = 0;
+    app_stats_http_request();
 
     /* Get ip address */
     wifi->get_ip_address(&sock_addr);
+    ip_addr = sock_addr.get_ip_address();
 
-    data_len = (strlen(create_wake_button1) + strlen(sock_addr.get_ip_address()) + strlen(create_wake_button2));
-    memset(http_app_response, '\0', sizeof(http_app_response));
-    
-    if (data_len < sizeof(http_app_response))
-    {
-        snprintf(http_app_response, data_len, "%s%s%s", create_wake_button1,
-                           sock_addr.get_ip_address(), create_wake_button2);
-    }
-    else
+    /* Send HTTP response and push it to the socket right away rather than
+     * when the handler returns.
+     */
+    result = http_page_write(stream, &sleep_page, ip_addr, strlen(ip_addr));
+    if (CY_RSLT_SUCCESS == result)
     {
-        ERR_INFO(("HTTP response string length exceeds the buffer size\r\n"));
+        result = server->http_response_stream_flush(stream);
     }
-
-    /* Send HTTP response. */
-    result = server->http_response_stream_write(stream, http_app_response, sizeof(http_app_response)-1);
     if (CY_RSLT_SUCCESS != result)
     {
         ERR_INFO(("Failed to write HTTP response\r\n"));
     }
 
     /* Suspend the network stack which allows the PSoC 6 MCU
-     * to enter deep sleep.
+     * to enter deep sleep. The request does not block; the sleep thread
+     * lets the response drain before it suspends the network stack.
      */
-    request_host_sleep_sema.release();
+    host_sleep_request();
 
     return result;
 }
@@ -216,28 +354,17 @@ int32_t host_wake_pageload(const char* url_path,
                           cy_http_message_body_t* http_data)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
-    uint32_t      data_len = 0;
     SocketAddress sock_addr;
+    const char *ip_addr = NULL;
+
+    app_stats_http_request();
 
     /* Get ip address */
     wifi->get_ip_address(&sock_addr);
+    ip_addr = sock_addr.get_ip_address();
 
-    data_len = (strlen(wake_host_str1) + strlen(sock_addr.get_ip_address()) + strlen(wake_host_str2));
-    memset(http_app_response, '\0', sizeof(http_app_response));
-    
-    if (data_len < sizeof(http_app_response))
-    {
-        snprintf(http_app_response, data_len, "%s%s%s", wake_host_str1,
-                           sock_addr.get_ip_address(), wake_host_str2);
-    }
-    else
-    {
-        ERR_INFO(("HTTP response string length exceeds the buffer size\r\n"));
-        return CY_RSLT_TYPE_ERROR;
-    }
-
-    APP_INFO(("http_app_response: %s\n", http_app_response));
-    result = server->http_response_stream_write(stream, http_app_response, sizeof(http_app_response) - 1);
+    APP_INFO(("Wake host redirect to http://%s\n", ip_addr));
+    result = http_page_write(stream, &wake_page, ip_addr, strlen(ip_addr));
     if (CY_RSLT_SUCCESS != result)
     {
         ERR_INFO(("Failed to write HTTP response\r\n"));
@@ -246,6 +373,53 @@ int32_t host_wake_pageload(const char* url_path,
     return result;
 }
 
+/******************************************************************************
+ * Function Name: stats_write_histogram
+ ******************************************************************************
+ * Summary:
+ *   This function writes one of the histograms of the statistics to the
+ *   sleep stats page, one line per non-empty bucket.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer of the response.
+ *   hist: Histogram to write.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void stats_write_histogram(http_stream_buf_t *sb, app_stats_hist_t hist)
+{
+    log2_histogram_t snapshot;
+
+    app_stats_get_histogram(hist, &snapshot);
+
+    http_stream_buf_write_str(sb, "\n");
+    http_stream_buf_write_str(sb, app_stats_histogram_name(hist));
+    http_stream_buf_write_str(sb, "(ms):");
+    for (uint32_t i = 0; i < LOG2_HISTOGRAM_BUCKETS; i++)
+    {
+        if (0 == snapshot.counts[i])
+        {
+            continue;
+        }
+
+        http_stream_buf_write_str(sb, "\n\t");
+        http_stream_buf_write_uint64(sb, log2_histogram_bucket_min(i));
+        if (i < (LOG2_HISTOGRAM_BUCKETS - 1))
+        {
+            http_stream_buf_write_str(sb, " - ");
+            http_stream_buf_write_uint64(sb, log2_histogram_bucket_min(i + 1) - 1);
+        }
+        else
+        {
+            http_stream_buf_write_str(sb, " and above");
+        }
+        http_stream_buf_write_str(sb, "\t:");
+        http_stream_buf_write_uint64(sb, snapshot.counts[i]);
+    }
+}
+
 /******************************************************************************
  * Function Name: sleep_stats_pageload
  ******************************************************************************
@@ -273,21 +447,405 @@ int32_t sleep_stats_pageload(const char* url_path,
                              cy_http_message_body_t* http_data)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
+    char chunk[HTTP_STREAM_CHUNK_LEN];
+    http_stream_buf_t sb;
+#if defined(MBED_CPU_STATS_ENABLED)
+    uint64_t uptime_sec = mbed_uptime() / 1000000;
+#endif
+    host_sleep_info_t sleep_info;
+    http_response_pool_stats_t pool_stats;
+    energy_estimate_t energy;
+
+    app_stats_http_request();
+    host_sleep_get_info(&sleep_info);
+    http_response_pool_get_stats(&pool_stats);
+
+    /* The page head and tail are sent from flash. The statistics in between
+     * are streamed through a small buffer, so the page is not limited by the
+     * size of a response buffer.
+     */
+    result = http_response_stream_writev(server, stream, &stats_page.head, 1);
+
+    http_stream_buf_init(&sb, server, stream, chunk, sizeof(chunk));
+    if (CY_RSLT_SUCCESS != result)
+    {
+        sb.result = result;
+    }
+
+    http_stream_buf_write_str(&sb, "OS sleep manager stats:");
+#if defined(MBED_CPU_STATS_ENABLED)
+    http_stream_buf_write_str(&sb, "\n\tuptime(hh:mm:ss)\t:");
+    http_stream_buf_write_uint64(&sb, uptime_sec / 3600);
+    http_stream_buf_write_str(&sb, ":");
+    http_stream_buf_write_uint64(&sb, (uptime_sec % 3600) / 60);
+    http_stream_buf_write_str(&sb, ":");
+    http_stream_buf_write_uint64(&sb, uptime_sec % 60);
+    http_stream_buf_write_str(&sb, ",\n\tidle(seconds)\t\t:");
+    http_stream_buf_write_uint64(&sb, mbed_time_idle() / 1000000);
+    http_stream_buf_write_str(&sb, ",\n\tsleep(seconds)\t\t:");
+    http_stream_buf_write_uint64(&sb, mbed_time_sleep() / 1000000);
+    http_stream_buf_write_str(&sb, ",\n\tdsleep(seconds)\t\t:");
+    http_stream_buf_write_uint64(&sb, mbed_time_deepsleep() / 1000000);
+    http_stream_buf_write_str(&sb, "\n ");
+#endif /* #if defined(MBED_CPU_STATS_ENABLED) */
+    http_stream_buf_write_str(&sb, "\nDeepsleep with Network Stack suspended(Low Power time):"
+                                   "\n\tHost Deepsleep(seconds)\t:");
+    http_stream_buf_write_uint64(&sb, cy_dsleep_nw_suspend_time / 1000000);
+    http_stream_buf_write_str(&sb, "\n\tHost sleep state\t:");
+    http_stream_buf_write_str(&sb, host_sleep_state_name(sleep_info.state));
+    http_stream_buf_write_str(&sb, "\nHTTP response buffers:"
+                                   "\n\tIn use\t\t\t:");
+    http_stream_buf_write_uint64(&sb, pool_stats.in_use);
+    http_stream_buf_write_str(&sb, " of ");
+    http_stream_buf_write_uint64(&sb, HTTP_RESPONSE_POOL_SIZE);
+    http_stream_buf_write_str(&sb, "\n\tPeak in use\t\t:");
+    http_stream_buf_write_uint64(&sb, pool_stats.peak_in_use);
+    http_stream_buf_write_str(&sb, "\n\tPeak bytes used\t\t:");
+    http_stream_buf_write_uint64(&sb, pool_stats.peak_bytes);
+    http_stream_buf_write_str(&sb, " of ");
+    http_stream_buf_write_uint64(&sb, HTTP_BYTES_LEN);
+    http_stream_buf_write_str(&sb, "\n\tAllocation failures\t:");
+    http_stream_buf_write_uint64(&sb, pool_stats.alloc_failures);
+    http_stream_buf_write_str(&sb, "\n\tPeak chunk bytes used\t:");
+    http_stream_buf_write_uint64(&sb, pool_stats.peak_chunk_bytes);
+    http_stream_buf_write_str(&sb, " of ");
+    http_stream_buf_write_uint64(&sb, HTTP_STREAM_CHUNK_LEN);
+    http_stream_buf_write_str(&sb, "\nHTTP response peak bytes per page:");
+    for (uint32_t i = 0; i < HTTP_RESPONSE_PAGE_MAX; i++)
+    {
+        const char *page_name = http_response_page_name((http_response_page_t)i);
+
+        /* Align the values with the lines above, with tab stops of 8. */
+        http_stream_buf_write_str(&sb, "\n\t");
+        http_stream_buf_write_str(&sb, page_name);
+        http_stream_buf_write_str(&sb, (strlen(page_name) < 8) ? "\t\t\t:" : "\t\t:");
+        http_stream_buf_write_uint64(&sb, pool_stats.page_peak_bytes[i]);
+    }
+    for (uint32_t i = 0; i < APP_STATS_HIST_MAX; i++)
+    {
+        stats_write_histogram(&sb, (app_stats_hist_t)i);
+    }
+    if (energy_model_estimate(&energy))
+    {
+        http_stream_buf_write_str(&sb, "\nEnergy estimate:"
+                                       "\n\tAverage current(uA)\t:");
+        http_stream_buf_write_uint64(&sb, energy.avg_current_ua);
+        http_stream_buf_write_str(&sb, "\n\tEnergy(mJ/hour)\t\t:");
+        http_stream_buf_write_uint64(&sb, energy.energy_mj_per_hour);
+        http_stream_buf_write_str(&sb, "\n\tBattery life(hours)\t:");
+        http_stream_buf_write_uint64(&sb, energy.battery_life_hours);
+    }
+    http_stream_buf_write_str(&sb, "\n");
+
+    result = http_stream_buf_flush(&sb);
+    http_response_chunk_used(HTTP_RESPONSE_PAGE_STATS, sb.peak_length);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = http_response_stream_writev(server, stream, &stats_page.tail, 1);
+    }
 
-    memset(http_app_response, '\0', sizeof(http_app_response));
-    snprintf(http_app_response, sizeof(http_app_response)-1, "%s"
-             "OS sleep manager stats:"
-             STR_FMT_UPTIME_STATS
-             "\nDeepsleep with Network Stack suspended(Low Power time):"
-             "\n\tHost Deepsleep(seconds)\t:%llu\n"
-             "%s",
-             sleep_stats_response1, UPTIME_STATS_ARGS,
-             (cy_dsleep_nw_suspend_time/1000000), sleep_stats_response2);
-
-    /* Send HTTP response. */
-    result = server->http_response_stream_write(stream,
-                                                http_app_response,
-                                                sizeof(http_app_response)-1);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: sleep_stats_json_pageload
+ ******************************************************************************
+ * Summary:
+ *   This function is called when a client requests '/stats.json'. It sends
+ *   the same sleep statistics as the 'Sleep stats' web page as a JSON object
+ *   for monitoring tools. All times are integers in microseconds.
+ *
+ * Parameters:
+ *   url_path: Pointer to HTTP url path.
+ *   url_query_string: Pointer to HTTP url query string.
+ *   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+ *   arg: Argument as set in callback registration.
+ *   http_data: Pointer to HTTP data.
+ *
+ * Return:
+ *   int32_t: Returns error code as defined in cy_rslt_t.
+ *
+ *****************************************************************************/
+int32_t sleep_stats_json_pageload(const char* url_path,
+                                  const char* url_query_string,
+                                  cy_http_response_stream_t* stream,
+                                  void* arg,
+                                  cy_http_message_body_t* http_data)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    json_writer_t json;
+    http_response_buf_t *response = NULL;
+    host_sleep_info_t sleep_info;
+    nw_inactivity_info_t nw_info;
+    energy_estimate_t energy;
+
+    app_stats_http_request();
+    host_sleep_get_info(&sleep_info);
+    nw_inactivity_get_info(&nw_info);
+
+    response = http_response_buf_alloc();
+    if (NULL == response)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    json_writer_init(&json, response->data, sizeof(response->data));
+    json_writer_begin_object(&json);
+#if defined(MBED_CPU_STATS_ENABLED)
+    json_writer_add_uint64(&json, "uptime", mbed_uptime());
+    json_writer_add_uint64(&json, "idle", mbed_time_idle());
+    json_writer_add_uint64(&json, "sleep", mbed_time_sleep());
+    json_writer_add_uint64(&json, "deepsleep", mbed_time_deepsleep());
+#endif /* #if defined(MBED_CPU_STATS_ENABLED) */
+    json_writer_add_uint64(&json, "nw_suspend_deepsleep", cy_dsleep_nw_suspend_time);
+    json_writer_add_string(&json, "sleep_state", host_sleep_state_name(sleep_info.state));
+    json_writer_add_uint64(&json, "awake_at_ms",
+                           sleep_info.entered_ms[HOST_SLEEP_STATE_AWAKE]);
+    json_writer_add_uint64(&json, "pending_suspend_at_ms",
+                           sleep_info.entered_ms[HOST_SLEEP_STATE_PENDING_SUSPEND]);
+    json_writer_add_uint64(&json, "suspended_at_ms",
+                           sleep_info.entered_ms[HOST_SLEEP_STATE_SUSPENDED]);
+    json_writer_add_uint64(&json, "resuming_at_ms",
+                           sleep_info.entered_ms[HOST_SLEEP_STATE_RESUMING]);
+    json_writer_add_uint64(&json, "resumed_at_ms", sleep_info.resumed_ms);
+    json_writer_add_uint64(&json, "sleep_requests_coalesced", sleep_info.requests_coalesced);
+    json_writer_add_uint64(&json, "sleep_requests_rearmed", sleep_info.requests_rearmed);
+    json_writer_add_uint64(&json, "nw_inactive_interval_ms", nw_info.interval_ms);
+    json_writer_add_uint64(&json, "nw_inactive_window_ms", nw_info.window_ms);
+    json_writer_add_uint64(&json, "nw_idle_gap_avg_ms", nw_info.idle_gap_ewma_ms);
+    json_writer_add_uint64(&json, "nw_awake_wait_avg_ms", nw_info.awake_wait_ewma_ms);
+    if (energy_model_estimate(&energy))
+    {
+        json_writer_add_uint64(&json, "avg_current_ua", energy.avg_current_ua);
+        json_writer_add_uint64(&json, "energy_mj_per_hour", energy.energy_mj_per_hour);
+        json_writer_add_uint64(&json, "battery_life_hours", energy.battery_life_hours);
+    }
+    json_writer_end_object(&json);
+
+    /* An overflowed document took the whole buffer. */
+    http_response_buf_used(HTTP_RESPONSE_PAGE_STATS_JSON,
+                           json_writer_ok(&json) ? (json.length + 1) : json.size);
+
+    if (json_writer_ok(&json))
+    {
+        const http_iovec_t iov = { json.buf, json.length };
+
+        result = http_response_stream_writev(server, stream, &iov, 1);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to write HTTP response\r\n"));
+        }
+    }
+    else
+    {
+        ERR_INFO(("HTTP response string length exceeds the buffer size\r\n"));
+        result = CY_RSLT_TYPE_ERROR;
+    }
+
+    http_response_buf_free(response);
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: metrics_write_counter
+ ******************************************************************************
+ * Summary:
+ *   This function writes one counter metric family in the OpenMetrics text
+ *   format.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer of the response.
+ *   name: Metric family name.
+ *   unit: Unit of the metric, or NULL if the metric has no unit.
+ *   help: Description of the metric.
+ *   value: Value of the counter. Times are given in microseconds.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void metrics_write_counter(http_stream_buf_t *sb, const char *name,
+                                  const char *unit, const char *help,
+                                  uint64_t value)
+{
+    http_stream_buf_write_str(sb, "# TYPE ");
+    http_stream_buf_write_str(sb, name);
+    http_stream_buf_write_str(sb, " counter\n");
+    if (NULL != unit)
+    {
+        http_stream_buf_write_str(sb, "# UNIT ");
+        http_stream_buf_write_str(sb, name);
+        http_stream_buf_write_str(sb, " ");
+        http_stream_buf_write_str(sb, unit);
+        http_stream_buf_write_str(sb, "\n");
+    }
+    http_stream_buf_write_str(sb, "# HELP ");
+    http_stream_buf_write_str(sb, name);
+    http_stream_buf_write_str(sb, " ");
+    http_stream_buf_write_str(sb, help);
+    http_stream_buf_write_str(sb, "\n");
+    http_stream_buf_write_str(sb, name);
+    http_stream_buf_write_str(sb, "_total ");
+    if ((NULL != unit) && (0 == strcmp(unit, "seconds")))
+    {
+        http_stream_buf_write_usec(sb, value);
+    }
+    else
+    {
+        http_stream_buf_write_uint64(sb, value);
+    }
+    http_stream_buf_write_str(sb, "\n");
+}
+
+/******************************************************************************
+ * Function Name: metrics_write_wake_reasons
+ ******************************************************************************
+ * Summary:
+ *   This function writes the wake counters and awake times in the
+ *   OpenMetrics text format, with one sample per wake reason, and the wakes
+ *   by unicast TCP and UDP frames with one sample per destination port.
+ *
+ * Parameters:
+ *   sb: Pointer to the stream buffer of the response.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void metrics_write_wake_reasons(http_stream_buf_t *sb)
+{
+    wake_reason_stats_t wake_stats;
+
+    wake_reason_get_stats(&wake_stats);
+
+    http_stream_buf_write_str(sb, "# TYPE arp_ol_wakes counter\n"
+                                  "# HELP arp_ol_wakes Resumes of the suspended network stack by wake reason.\n");
+    for (uint32_t i = 0; i < WAKE_REASON_MAX; i++)
+    {
+        http_stream_buf_write_str(sb, "arp_ol_wakes_total{reason=\"");
+        http_stream_buf_write_str(sb, wake_reason_name((wake_reason_t)i));
+        http_stream_buf_write_str(sb, "\"} ");
+        http_stream_buf_write_uint64(sb, wake_stats.wakes[i]);
+        http_stream_buf_write_str(sb, "\n");
+    }
+
+    http_stream_buf_write_str(sb, "# TYPE arp_ol_wake_awake_seconds counter\n"
+                                  "# UNIT arp_ol_wake_awake_seconds seconds\n"
+                                  "# HELP arp_ol_wake_awake_seconds Time the network stack stayed up after a resume, by wake reason.\n");
+    for (uint32_t i = 0; i < WAKE_REASON_MAX; i++)
+    {
+        http_stream_buf_write_str(sb, "arp_ol_wake_awake_seconds_total{reason=\"");
+        http_stream_buf_write_str(sb, wake_reason_name((wake_reason_t)i));
+        http_stream_buf_write_str(sb, "\"} ");
+        http_stream_buf_write_usec(sb, wake_stats.awake_ms[i] * 1000);
+        http_stream_buf_write_str(sb, "\n");
+    }
+
+    http_stream_buf_write_str(sb, "# TYPE arp_ol_wake_ports counter\n"
+                                  "# HELP arp_ol_wake_ports Resumes by a unicast TCP or UDP frame, by destination port.\n");
+    for (uint32_t i = 0; (i < WAKE_REASON_PORTS) && (0 != wake_stats.ports[i].protocol); i++)
+    {
+        http_stream_buf_write_str(sb, "arp_ol_wake_ports_total{protocol=\"");
+        http_stream_buf_write_str(sb, (WAKE_REASON_IP_PROTO_TCP == wake_stats.ports[i].protocol) ?
+                                      "tcp" : "udp");
+        http_stream_buf_write_str(sb, "\",port=\"");
+        http_stream_buf_write_uint64(sb, wake_stats.ports[i].port);
+        http_stream_buf_write_str(sb, "\"} ");
+        http_stream_buf_write_uint64(sb, wake_stats.ports[i].wakes);
+        http_stream_buf_write_str(sb, "\n");
+    }
+}
+
+/******************************************************************************
+ * Function Name: metrics_pageload
+ ******************************************************************************
+ * Summary:
+ *   This function is called when a client requests '/metrics'. It sends the
+ *   sleep and network suspend statistics and the HTTP server counters in the
+ *   OpenMetrics text format for scraping by monitoring systems. The output
+ *   is streamed through a small buffer, so it is not limited by
+ *   HTTP_BYTES_LEN.
+ *
+ * Parameters:
+ *   url_path: Pointer to HTTP url path.
+ *   url_query_string: Pointer to HTTP url query string.
+ *   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+ *   arg: Argument as set in callback registration.
+ *   http_data: Pointer to HTTP data.
+ *
+ * Return:
+ *   int32_t: Returns error code as defined in cy_rslt_t.
+ *
+ *****************************************************************************/
+int32_t metrics_pageload(const char* url_path,
+                         const char* url_query_string,
+                         cy_http_response_stream_t* stream,
+                         void* arg,
+                         cy_http_message_body_t* http_data)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    char chunk[HTTP_STREAM_CHUNK_LEN];
+    http_stream_buf_t sb;
+    app_stats_t stats;
+    host_sleep_info_t sleep_info;
+
+    app_stats_http_request();
+    app_stats_get(&stats);
+    host_sleep_get_info(&sleep_info);
+
+    http_stream_buf_init(&sb, server, stream, chunk, sizeof(chunk));
+
+#if defined(MBED_CPU_STATS_ENABLED)
+    metrics_write_counter(&sb, "arp_ol_uptime_seconds", "seconds",
+                          "Time since startup.", mbed_uptime());
+    metrics_write_counter(&sb, "arp_ol_idle_seconds", "seconds",
+                          "Time spent in the idle thread.", mbed_time_idle());
+    metrics_write_counter(&sb, "arp_ol_sleep_seconds", "seconds",
+                          "Time spent in sleep.", mbed_time_sleep());
+    metrics_write_counter(&sb, "arp_ol_deepsleep_seconds", "seconds",
+                          "Time spent in deep sleep.", mbed_time_deepsleep());
+#endif /* #if defined(MBED_CPU_STATS_ENABLED) */
+    metrics_write_counter(&sb, "arp_ol_nw_suspend_deepsleep_seconds", "seconds",
+                          "Time spent in deep sleep with the network stack suspended.",
+                          cy_dsleep_nw_suspend_time);
+    metrics_write_counter(&sb, "arp_ol_nw_suspend_attempts", NULL,
+                          "Attempts to suspend the network stack.",
+                          stats.nw_suspend_attempts);
+    metrics_write_counter(&sb, "arp_ol_nw_suspends", NULL,
+                          "Network stack suspends, each followed by a resume.",
+                          stats.nw_suspends);
+    metrics_write_counter(&sb, "arp_ol_nw_suspend_abandoned", NULL,
+                          "Sleep requests dropped without a network stack suspend.",
+                          stats.nw_suspend_abandoned);
+    metrics_write_counter(&sb, "arp_ol_sleep_requests_coalesced", NULL,
+                          "Sleep requests merged with a suspend already pending or running.",
+                          sleep_info.requests_coalesced);
+    metrics_write_counter(&sb, "arp_ol_sleep_requests_rearmed", NULL,
+                          "Suspends started again for a sleep request made during a suspend.",
+                          sleep_info.requests_rearmed);
+    metrics_write_wake_reasons(&sb);
+    metrics_write_counter(&sb, "arp_ol_http_requests", NULL,
+                          "Requests served by the dynamic pages.",
+                          stats.http_requests);
+    metrics_write_counter(&sb, "arp_ol_http_sent_bytes", "bytes",
+                          "Body bytes sent by the dynamic pages.",
+                          stats.http_bytes_sent);
+    metrics_write_counter(&sb, "arp_ol_http_eviction_passes", NULL,
+                          "Passes closing all HTTP connections before a network stack suspend.",
+                          stats.http_eviction_passes);
+    metrics_write_counter(&sb, "arp_ol_http_drain_timeouts", NULL,
+                          "Suspends with an HTTP response not yet acknowledged.",
+                          stats.http_drain_timeouts);
+    http_stream_buf_write_str(&sb, "# EOF\n");
+
+    result = http_stream_buf_flush(&sb);
+    http_response_chunk_used(HTTP_RESPONSE_PAGE_METRICS, sb.peak_length);
     if (CY_RSLT_SUCCESS != result)
     {
         ERR_INFO(("Failed to write HTTP response\r\n"));
@@ -320,33 +878,27 @@ void app_http_server_init(WhdSTAInterface *wifi)
     nw_interface.object = (void *)wifi;
     nw_interface.type   = CY_NW_INF_TYPE_WIFI;
 
+    APP_INFO(("HTTP sockets: %u, RAM per socket: up to %u bytes "
+              "(response buffer: %u, lwIP: up to %u), total: up to %u of %u bytes\n",
+              (unsigned int)MAX_SOCKETS, (unsigned int)HTTP_SOCKET_RAM,
+              (unsigned int)HTTP_SOCKET_RESPONSE_RAM,
+              (unsigned int)HTTP_SOCKET_LWIP_RAM,
+              (unsigned int)(MAX_SOCKETS * HTTP_SOCKET_RAM),
+              (unsigned int)MBED_CONF_APP_HTTP_RAM_BUDGET));
+
     /* Initialize HTTP server object. */
     server = new HTTPServer(&nw_interface, HTTP_PORT, MAX_SOCKETS);
 
     /* Register HTTP page resources. */
-    result = server->register_resource((uint8_t*)"/",
-                                       (uint8_t*)"text/html",
-                                       CY_STATIC_URL_CONTENT,
-                                       &test_data);
-    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/' failed.\n");
-
-    result = server->register_resource((uint8_t*)"/sleep",
-                                       (uint8_t*)"text/html",
-                                       CY_DYNAMIC_URL_CONTENT,
-                                       &http_data_sleep_url);
-    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/sleep' failed.\n");
-
-    result = server->register_resource((uint8_t*)"/stats",
-                                       (uint8_t*)"text/html",
-                                       CY_DYNAMIC_URL_CONTENT,
-                                       &http_data_stats_url);
-    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/stats' failed.\n");
-
-    result = server->register_resource((uint8_t*)"/wake",
-                                       (uint8_t*)"text/html",
-                                       CY_DYNAMIC_URL_CONTENT,
-                                       &http_data_wake_url);
-    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/wake' failed.\n");
+    for (uint32_t i = 0; i < (sizeof(http_routes) / sizeof(http_routes[0])); i++)
+    {
+        result = server->register_resource((uint8_t*)http_routes[i].url,
+                                           (uint8_t*)http_routes[i].mime_type,
+                                           http_routes[i].type,
+                                           http_routes[i].resource);
+        PRINT_AND_ASSERT(result, "Registering HTTP page resource '%s' failed.\n",
+                         http_routes[i].url);
+    }
 
     /* Start HTTP server */
     result = server->start();
@@ -359,5 +911,144 @@ void app_http_server_init(WhdSTAInterface *wifi)
 }
 
 
+/******************************************************************************
+ * Function Name: app_http_server_routes
+ ******************************************************************************
+ * Summary:
+ *   This function returns the resources registered with the HTTP server, in
+ *   registration order, which is the order the server looks them up in.
+ *
+ * Parameters:
+ *   count: Pointer to the number of resources, set by this function.
+ *
+ * Return:
+ *   const app_http_route_t*: The resources.
+ *
+ *****************************************************************************/
+const app_http_route_t *app_http_server_routes(uint32_t *count)
+{
+    *count = (uint32_t)(sizeof(http_routes) / sizeof(http_routes[0]));
+
+    return http_routes;
+}
+
+/******************************************************************************
+ * Function Name: app_http_server_evict_connections
+ ******************************************************************************
+ * Summary:
+ *   This function closes all the connections of the HTTP server. It is
+ *   called before the network stack is suspended: a browser keeps idle
+ *   connections open, and the keep-alive traffic on them would stop the
+ *   network from ever being inactive long enough to suspend the stack.
+ *   Browsers open a new connection on the next request.
+ *
+ *   It runs on the sleep thread, not the HTTP server thread: the HTTP
+ *   server library offers no way to run code on its thread. The library
+ *   closes each connection through the Mbed OS socket API, which locks the
+ *   socket and hands the close to the tcpip thread, so the close is safe
+ *   from any thread. The server thread then sees the connection closed, as
+ *   when the client closes it. The sleep thread calls this function only
+ *   after app_http_server_drain_responses(), so normally no response is in
+ *   flight. A request that arrives during the eviction fails the way it
+ *   would if the client had dropped the connection, and the browser sends
+ *   it again on a new one.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_http_server_evict_connections(void)
+{
+#if MBED_CONF_APP_HTTP_EVICT_BEFORE_SUSPEND
+    cy_rslt_t result = server->http_response_stream_disconnect_all();
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        app_stats_http_eviction_pass();
+    }
+    else
+    {
+        ERR_INFO(("Failed to close the HTTP connections\r\n"));
+    }
+#endif /* #if MBED_CONF_APP_HTTP_EVICT_BEFORE_SUSPEND */
+}
+
+
+/******************************************************************************
+ * Function Name: http_responses_pending
+ ******************************************************************************
+ * Summary:
+ *   This function checks the TCP control blocks of the HTTP connections for
+ *   response data that lwIP has not sent yet or that the client has not
+ *   acknowledged. lwIP does not export the control blocks of accepted
+ *   connections, so the list tcp_active_pcbs and the tcp_pcb fields are
+ *   read from lwip/priv/tcp_priv.h, as laid out in lwIP 2.1, the version
+ *   in Mbed OS 6. Check them when lwIP is updated. The list is only read
+ *   under the tcpip core lock, which needs LWIP_TCPIP_CORE_LOCKING.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   bool: true if a connection of the HTTP server still has data to send or
+ *     to be acknowledged.
+ *
+ *****************************************************************************/
+static bool http_responses_pending(void)
+{
+    struct tcp_pcb *pcb;
+    bool pending = false;
+
+    LOCK_TCPIP_CORE();
+    for (pcb = tcp_active_pcbs; (NULL != pcb) && !pending; pcb = pcb->next)
+    {
+        pending = (HTTP_PORT == pcb->local_port) &&
+                  ((NULL != pcb->unsent) || (NULL != pcb->unacked) || (0 != pcb->snd_queuelen));
+    }
+    UNLOCK_TCPIP_CORE();
+
+    return pending;
+}
+
+/******************************************************************************
+ * Function Name: app_http_server_drain_responses
+ ******************************************************************************
+ * Summary:
+ *   This function waits until the HTTP responses have been sent and
+ *   acknowledged, so that the network stack is not suspended with a response
+ *   in flight: the retransmission, or the late ACK of the client, would
+ *   resume the stack right away. The TCP control blocks are polled every
+ *   HTTP_DRAIN_POLL_MS. If the client has not acknowledged the responses
+ *   within 'timeout_ms', the timeout is counted and the suspend goes ahead.
+ *
+ * Parameters:
+ *   timeout_ms: Longest time to wait in milliseconds.
+ *
+ * Return:
+ *   bool: true if the responses drained, false on timeout.
+ *
+ *****************************************************************************/
+bool app_http_server_drain_responses(uint32_t timeout_ms)
+{
+    uint32_t waited_ms = 0;
+
+    while (http_responses_pending())
+    {
+        if (waited_ms >= timeout_ms)
+        {
+            app_stats_http_drain_timeout();
+            return false;
+        }
+        ThisThread::sleep_for(std::chrono::milliseconds(HTTP_DRAIN_POLL_MS));
+        waited_ms += HTTP_DRAIN_POLL_MS;
+    }
+
+    return true;
+}
+
+
 /* [] END OF FILE */
 
@@ -43,35 +43,20 @@
 #include "mbed.h"
 #include "HTTP_server.hpp"
 #include "WhdSTAInterface.h"
+#include "http_response_writer.h"
 
 /******************************************************************************
  *                                  MACROS
  *****************************************************************************/
 #define HTTP_BYTES_LEN           (1024)
 #define HTTP_PORT                (80u)
-#define MAX_SOCKETS              (2u)
-#define MAX_HTTP_APP_STR_LEN     ((sizeof(startup_response) * 2))
-
-#if defined(MBED_CPU_STATS_ENABLED)
-#define STR_FMT_UPTIME_STATS     "\n\tuptime(hh:mm:ss)\t:%llu:%llu:%llu," \
-                                 "\n\tidle(seconds)\t\t:%llu,"            \
-                                 "\n\tsleep(seconds)\t\t:%llu,"           \
-                                 "\n\tdsleep(seconds)\t\t:%llu\n "
-#define UPTIME_IN_SECONDS        (mbed_uptime() / 1000000)
-#define UPTIME_STATS_HOURS       (UPTIME_IN_SECONDS / 3600)
-#define UPTIME_STATS_MINS        ((UPTIME_IN_SECONDS - (3600 * UPTIME_STATS_HOURS)) / 60)
-#define UPTIME_STATS_SECONDS     (UPTIME_IN_SECONDS - (3600 * UPTIME_STATS_HOURS) - (UPTIME_STATS_MINS * 60))
-
-#define UPTIME_STATS_ARGS        UPTIME_STATS_HOURS,            \
-                                 UPTIME_STATS_MINS,             \
-                                 UPTIME_STATS_SECONDS,          \
-                                 (mbed_time_idle()/1000000),    \
-                                 (mbed_time_sleep()/1000000),   \
-                                 (mbed_time_deepsleep()/1000000)
-#else
-#define STR_FMT_UPTIME_STATS
-#define UPTIME_STATS_ARGS
-#endif /* #if defined(MBED_CPU_STATS_ENABLED) */
+#define MAX_SOCKETS              (MBED_CONF_APP_HTTP_MAX_SOCKETS)
+#define HTTP_STREAM_CHUNK_LEN    (256)
+
+/* Period in milliseconds at which the HTTP connections are checked for
+ * unacknowledged responses before the network stack is suspended.
+ */
+#define HTTP_DRAIN_POLL_MS       (10)
 
 #define APP_INFO(x)              do { printf("Info: "); printf x; } while(0);
 #define ERR_INFO(x)              do { printf("Error: "); printf x; } while(0);
@@ -86,6 +71,30 @@
                                      }                              \
                                  } while(0);
 
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Page made of a static head and tail with one dynamic slot in between.
+ * The page text lives in flash and its length is resolved at compile time,
+ * so it is sent without copying or strlen().
+ */
+typedef struct
+{
+    http_iovec_t head;
+    http_iovec_t tail;
+} http_page_template_t;
+
+/* Resource registered with the HTTP server at startup. */
+typedef struct
+{
+    const char           *url;
+    const char           *mime_type;
+    cy_url_resource_type  type;
+    void                 *resource;
+} app_http_route_t;
+
+#define HTTP_PAGE_FRAGMENT(str)  { (str), (sizeof(str) - 1) }
+
 /*********************************************************************
  *                      FUNCTION DECLARATIONS
  ********************************************************************/
@@ -107,7 +116,22 @@ int32_t sleep_stats_pageload(const char* url_path,
                              void* arg,
                              cy_http_message_body_t* http_data);
 
+int32_t sleep_stats_json_pageload(const char* url_path,
+                                  const char* url_query_string,
+                                  cy_http_response_stream_t* stream,
+                                  void* arg,
+                                  cy_http_message_body_t* http_data);
+
+int32_t metrics_pageload(const char* url_path,
+                         const char* url_query_string,
+                         cy_http_response_stream_t* stream,
+                         void* arg,
+                         cy_http_message_body_t* http_data);
+
 void app_http_server_init(WhdSTAInterface *wifi);
+const app_http_route_t *app_http_server_routes(uint32_t *count);
+void app_http_server_evict_connections(void);
+bool app_http_server_drain_responses(uint32_t timeout_ms);
 
 #endif /* #ifndef HTTP_WEBSERVER_CONFIG_H */
 
@@ -0,0 +1,240 @@
+/******************************************************************************
+ * File Name: json_writer.cpp
+ *
+ * Description:
+ *   This file contains a minimal JSON writer that emits objects with unsigned
+ *   integer and string members into a fixed buffer.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "json_writer.h"
+#include "num_to_str.h"
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: json_writer_append
+ ******************************************************************************
+ * Summary:
+ *   This function appends raw characters to the JSON document. If they do
+ *   not fit, nothing is appended and the writer is marked as overflowed.
+ *
+ * Parameters:
+ *   writer: Pointer to the JSON writer.
+ *   str: Characters to append.
+ *   len: Number of characters to append.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void json_writer_append(json_writer_t *writer, const char *str, uint32_t len)
+{
+    /* Always keep room for the NUL terminator. */
+    if (writer->overflow || (len >= (writer->size - writer->length)))
+    {
+        writer->overflow = true;
+        return;
+    }
+
+    memcpy(&writer->buf[writer->length], str, len);
+    writer->length += len;
+    writer->buf[writer->length] = '\0';
+}
+
+/******************************************************************************
+ * Function Name: json_writer_add_key
+ ******************************************************************************
+ * Summary:
+ *   This function starts a member of the JSON object opened last by writing
+ *   the separator from the previous member and the member name.
+ *
+ * Parameters:
+ *   writer: Pointer to the JSON writer.
+ *   key: Member name.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void json_writer_add_key(json_writer_t *writer, const char *key)
+{
+    if (!writer->first_member)
+    {
+        json_writer_append(writer, ",", 1);
+    }
+    writer->first_member = false;
+
+    json_writer_append(writer, "\"", 1);
+    json_writer_append(writer, key, strlen(key));
+    json_writer_append(writer, "\":", 2);
+}
+
+/******************************************************************************
+ * Function Name: json_writer_init
+ ******************************************************************************
+ * Summary:
+ *   This function prepares a JSON writer to write into the given buffer.
+ *
+ * Parameters:
+ *   writer: Pointer to the JSON writer.
+ *   buf: Buffer that receives the NUL terminated JSON document.
+ *   size: Size of the buffer in bytes.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void json_writer_init(json_writer_t *writer, char *buf, uint32_t size)
+{
+    writer->buf          = buf;
+    writer->size         = size;
+    writer->length       = 0;
+    writer->first_member = true;
+    writer->overflow     = ((NULL == buf) || (0 == size));
+
+    if (!writer->overflow)
+    {
+        writer->buf[0] = '\0';
+    }
+}
+
+/******************************************************************************
+ * Function Name: json_writer_begin_object
+ ******************************************************************************
+ * Summary:
+ *   This function opens a JSON object.
+ *
+ * Parameters:
+ *   writer: Pointer to the JSON writer.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void json_writer_begin_object(json_writer_t *writer)
+{
+    json_writer_append(writer, "{", 1);
+    writer->first_member = true;
+}
+
+/******************************************************************************
+ * Function Name: json_writer_end_object
+ ******************************************************************************
+ * Summary:
+ *   This function closes the JSON object opened last.
+ *
+ * Parameters:
+ *   writer: Pointer to the JSON writer.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void json_writer_end_object(json_writer_t *writer)
+{
+    json_writer_append(writer, "}", 1);
+    writer->first_member = false;
+}
+
+/******************************************************************************
+ * Function Name: json_writer_add_uint64
+ ******************************************************************************
+ * Summary:
+ *   This function adds a member with an unsigned integer value to the JSON
+ *   object opened last. The key is written as is and must not need escaping.
+ *
+ * Parameters:
+ *   writer: Pointer to the JSON writer.
+ *   key: Member name.
+ *   value: Member value.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void json_writer_add_uint64(json_writer_t *writer, const char *key, uint64_t value)
+{
+    char digits[UINT64_MAX_DIGITS];
+
+    json_writer_add_key(writer, key);
+    json_writer_append(writer, digits, uint64_to_str(value, digits, sizeof(digits)));
+}
+
+/******************************************************************************
+ * Function Name: json_writer_add_string
+ ******************************************************************************
+ * Summary:
+ *   This function adds a member with a string value to the JSON object
+ *   opened last. The key and the value are written as is and must not need
+ *   escaping.
+ *
+ * Parameters:
+ *   writer: Pointer to the JSON writer.
+ *   key: Member name.
+ *   value: Member value.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void json_writer_add_string(json_writer_t *writer, const char *key, const char *value)
+{
+    json_writer_add_key(writer, key);
+    json_writer_append(writer, "\"", 1);
+    json_writer_append(writer, value, strlen(value));
+    json_writer_append(writer, "\"", 1);
+}
+
+/******************************************************************************
+ * Function Name: json_writer_ok
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether the whole JSON document fit in the buffer.
+ *
+ * Parameters:
+ *   writer: Pointer to the JSON writer.
+ *
+ * Return:
+ *   bool: true if no output was dropped, false otherwise.
+ *
+ *****************************************************************************/
+bool json_writer_ok(const json_writer_t *writer)
+{
+    return !writer->overflow;
+}
+
+
+/* [] END OF FILE */
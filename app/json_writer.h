@@ -0,0 +1,75 @@
+/******************************************************************************
+ * File Name: json_writer.h
+ *
+ * Description:
+ *   This is the header file and contains the type definition and function
+ *   declarations for the JSON writer defined in json_writer.cpp file.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* State of a JSON document being written into a caller-provided buffer.
+ * Nothing is allocated; once the buffer is full, 'overflow' is set and
+ * further output is dropped.
+ */
+typedef struct
+{
+    char     *buf;
+    uint32_t  size;
+    uint32_t  length;
+    bool      first_member;
+    bool      overflow;
+} json_writer_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+void json_writer_init(json_writer_t *writer, char *buf, uint32_t size);
+void json_writer_begin_object(json_writer_t *writer);
+void json_writer_end_object(json_writer_t *writer);
+void json_writer_add_uint64(json_writer_t *writer, const char *key, uint64_t value);
+void json_writer_add_string(json_writer_t *writer, const char *key, const char *value);
+bool json_writer_ok(const json_writer_t *writer);
+
+#endif /* #ifndef JSON_WRITER_H */
+
+
+/* [] END OF FILE */
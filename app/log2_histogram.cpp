@@ -0,0 +1,118 @@
+/******************************************************************************
+ * File Name: log2_histogram.cpp
+ *
+ * Description:
+ *   This file contains histograms with buckets that double in width. A value
+ *   is recorded with one atomic increment, so values can be recorded from
+ *   any thread without locking.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "log2_histogram.h"
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: log2_histogram_record
+ ******************************************************************************
+ * Summary:
+ *   This function counts a value in the bucket it falls in.
+ *
+ * Parameters:
+ *   hist: Pointer to the histogram.
+ *   value: Value to record.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void log2_histogram_record(log2_histogram_t *hist, uint32_t value)
+{
+    uint32_t bucket = 0;
+
+    if (0 != value)
+    {
+        /* Number of significant bits of the value. */
+        bucket = 32 - __builtin_clz(value);
+    }
+    if (bucket >= LOG2_HISTOGRAM_BUCKETS)
+    {
+        bucket = LOG2_HISTOGRAM_BUCKETS - 1;
+    }
+
+    core_util_atomic_incr_u32(&hist->counts[bucket], 1);
+}
+
+/******************************************************************************
+ * Function Name: log2_histogram_get
+ ******************************************************************************
+ * Summary:
+ *   This function takes a snapshot of a histogram.
+ *
+ * Parameters:
+ *   hist: Pointer to the histogram.
+ *   snapshot: Pointer to the histogram that receives the snapshot.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void log2_histogram_get(log2_histogram_t *hist, log2_histogram_t *snapshot)
+{
+    for (uint32_t i = 0; i < LOG2_HISTOGRAM_BUCKETS; i++)
+    {
+        snapshot->counts[i] = core_util_atomic_load_u32(&hist->counts[i]);
+    }
+}
+
+/******************************************************************************
+ * Function Name: log2_histogram_bucket_min
+ ******************************************************************************
+ * Summary:
+ *   This function returns the smallest value counted in a bucket.
+ *
+ * Parameters:
+ *   bucket: Index of the bucket.
+ *
+ * Return:
+ *   uint32_t: Smallest value of the bucket.
+ *
+ *****************************************************************************/
+uint32_t log2_histogram_bucket_min(uint32_t bucket)
+{
+    return (0 == bucket) ? 0 : (1UL << (bucket - 1));
+}
+
+
+/* [] END OF FILE */
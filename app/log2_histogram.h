@@ -0,0 +1,74 @@
+/******************************************************************************
+ * File Name: log2_histogram.h
+ *
+ * Description:
+ *   This file contains the macros, type definitions and function
+ *   declarations for the log2 histograms defined in log2_histogram.cpp file.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef LOG2_HISTOGRAM_H
+#define LOG2_HISTOGRAM_H
+
+#include "mbed.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+/* Number of buckets of a histogram. Bucket 0 counts the value 0, bucket i
+ * the values from 2^(i-1) to 2^i - 1, and the last bucket all the values
+ * from 2^(LOG2_HISTOGRAM_BUCKETS - 2) up. With values in milliseconds, the
+ * last bucket starts at about 12 days, so sleep episodes of hours or days
+ * still fall in buckets of their own.
+ */
+#define LOG2_HISTOGRAM_BUCKETS   (32)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+typedef struct
+{
+    uint32_t counts[LOG2_HISTOGRAM_BUCKETS];
+} log2_histogram_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+void log2_histogram_record(log2_histogram_t *hist, uint32_t value);
+void log2_histogram_get(log2_histogram_t *hist, log2_histogram_t *snapshot);
+uint32_t log2_histogram_bucket_min(uint32_t bucket);
+
+#endif /* #ifndef LOG2_HISTOGRAM_H */
+
+
+/* [] END OF FILE */
@@ -47,35 +47,12 @@
 
 #include "mbed.h"
 #include "http_webserver_config.h"
-#include "network_activity_handler.h"
-
-/******************************************************************************
- *                              MACROS
- *****************************************************************************/
-/* This macro specifies the interval in milliseconds that the device monitors
- * the network for inactivity. If the network is inactive for duration lesser
- * than NETWORK_INACTIVE_WINDOW_MS in this interval, the MCU does not suspend
- * the network stack and informs the calling function that the MCU wait period
- * timed out while waiting for network to become inactive.
- */
-#define NETWORK_INACTIVE_INTERVAL_MS   (500)
-
-/* This macro specifies the continuous duration in milliseconds for which the
- * network has to be inactive. If the network is inactive for this duaration,
- * the MCU will suspend the network stack. Now, the MCU will not need to service
- * the network timers which allows it to stay longer in sleep/deepsleep.
- */
-#define NETWORK_INACTIVE_WINDOW_MS     (250)
+#include "nw_suspend.h"
+#include "wake_reason.h"
 
 /******************************************************************************
  *                         GLOBAL VARIABLES
  *****************************************************************************/
-/* Semaphore handle to cause host deep sleep on user request. */
-Semaphore request_host_sleep_sema(0);
-
-/* Thread handle to suspend/resume the host network stack. */
-Thread T1;
-
 /* Wi-Fi (STA) object handle.*/
 WhdSTAInterface *wifi;
 
@@ -209,9 +186,10 @@ cy_rslt_t app_wl_connect(WhdSTAInterface *wifi, const char *ssid,
  ******************************************************************************
  * Summary:
  *   This function waits for HTTP user request to click on 'Simulate Host Sleep'
- *   web button which causes the semaphore to get released. This function will
- *   acquire the semaphore and cause the Host network suspension. This allows
- *   the Host MCU to go to deep-sleep.
+ *   web button which raises a sleep request. Once the response to the request
+ *   has been sent, this function causes the Host network suspension. This allows
+ *   the Host MCU to go to deep-sleep. It runs on the main thread and never
+ *   returns.
  *
  * Parameters:
  *   void
@@ -224,20 +202,7 @@ void host_sleep_action_thread(void)
 {
     do
     {
-        /* Wait for the HTTP user request to put the host in deep sleep. */
-        request_host_sleep_sema.acquire();
-
-        /* Configures an emac activity callback to the Wi-Fi interface
-         * and suspends the network stack if the network is inactive for
-         * a duration of INACTIVE_WINDOW_MS inside an interval of
-         * INACTIVE_INTERVAL_MS. The callback is used to signal the
-         * presence/absence of network activity to resume/suspend the
-         * network stack.
-         */
-        wait_net_suspend(static_cast<WhdSTAInterface*>(wifi),
-                         osWaitForever,
-                         NETWORK_INACTIVE_INTERVAL_MS,
-                         NETWORK_INACTIVE_WINDOW_MS);
+        nw_suspend_run(wifi);
     } while(1);
 }
 
@@ -271,14 +236,18 @@ int main(void)
     PRINT_AND_ASSERT(result, "Failed to connect to AP. "
                      "Check Wi-Fi credentials in mbed_app.json file.\n");
 
+    /* Classify the frames that resume the suspended network stack */
+    wake_reason_init();
+
     /* Initializes and starts HTTP Web Server */
     app_http_server_init(static_cast<WhdSTAInterface*>(wifi));
 
-    /* Start application thread. Waits for a semaphore to be released
-     * via HTTP request and puts the Host system into deep
-     * sleep after acquiring the semaphore.
+    /* Run the host sleep loop on the main thread instead of a thread of its
+     * own, so no extra thread stack is allocated. Waits for a sleep request
+     * via HTTP and puts the Host system into deep sleep once the response
+     * to the request has been sent.
      */
-    T1.start(host_sleep_action_thread);
+    host_sleep_action_thread();
 
     return 0;
 }
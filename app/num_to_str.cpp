@@ -0,0 +1,129 @@
+/******************************************************************************
+ * File Name: num_to_str.cpp
+ *
+ * Description:
+ *   This file contains number to string conversions used to build HTTP
+ *   responses. They do not use printf, so 64-bit values do not depend on
+ *   the C library's %llu support.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "num_to_str.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define USEC_PER_SEC             (1000000u)
+#define USEC_DIGITS              (6u)
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: uint64_to_str
+ ******************************************************************************
+ * Summary:
+ *   This function converts an unsigned integer to its decimal representation.
+ *   The result is not NUL terminated.
+ *
+ * Parameters:
+ *   value: Value to convert.
+ *   buf: Buffer that receives the digits.
+ *   size: Size of the buffer in bytes.
+ *
+ * Return:
+ *   uint32_t: Number of digits written, or 0 if the buffer is too small.
+ *
+ *****************************************************************************/
+uint32_t uint64_to_str(uint64_t value, char *buf, uint32_t size)
+{
+    char digits[UINT64_MAX_DIGITS];
+    uint32_t pos = sizeof(digits);
+
+    /* Convert from the least significant digit into the end of 'digits'. */
+    do
+    {
+        digits[--pos] = (char)('0' + (value % 10u));
+        value /= 10u;
+    } while (0u != value);
+
+    if ((sizeof(digits) - pos) > size)
+    {
+        return 0;
+    }
+
+    memcpy(buf, &digits[pos], sizeof(digits) - pos);
+
+    return (sizeof(digits) - pos);
+}
+
+/******************************************************************************
+ * Function Name: usec_to_sec_str
+ ******************************************************************************
+ * Summary:
+ *   This function converts a time in microseconds to seconds with six
+ *   decimals, for example 1500000 to "1.500000". The result is not NUL
+ *   terminated.
+ *
+ * Parameters:
+ *   usec: Time in microseconds.
+ *   buf: Buffer that receives the characters.
+ *   size: Size of the buffer in bytes.
+ *
+ * Return:
+ *   uint32_t: Number of characters written, or 0 if the buffer is too small.
+ *
+ *****************************************************************************/
+uint32_t usec_to_sec_str(uint64_t usec, char *buf, uint32_t size)
+{
+    uint32_t len = uint64_to_str(usec / USEC_PER_SEC, buf, size);
+    uint32_t frac = (uint32_t)(usec % USEC_PER_SEC);
+
+    if ((0 == len) || ((len + 1 + USEC_DIGITS) > size))
+    {
+        return 0;
+    }
+
+    buf[len] = '.';
+    for (uint32_t i = USEC_DIGITS; i > 0; i--)
+    {
+        buf[len + i] = (char)('0' + (frac % 10u));
+        frac /= 10u;
+    }
+
+    return (len + 1 + USEC_DIGITS);
+}
+
+
+/* [] END OF FILE */
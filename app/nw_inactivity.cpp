@@ -0,0 +1,257 @@
+/******************************************************************************
+ * File Name: nw_inactivity.cpp
+ *
+ * Description:
+ *   This file contains the adaptive network inactivity window passed to
+ *   wait_net_suspend(). After each suspend, the time the network stack
+ *   stayed suspended is taken as an idle gap of the network traffic. While
+ *   the idle gaps are too short for a suspend to pay off, the window grows,
+ *   so that the stack is only suspended after a longer quiet period. While
+ *   they are long enough, the window shrinks, so that the stack is suspended
+ *   sooner and the host spends more time in deep sleep.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "nw_inactivity.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+#define NW_INACTIVITY_RATIO   (NETWORK_INACTIVE_INTERVAL_MS / NETWORK_INACTIVE_WINDOW_MS)
+
+MBED_STATIC_ASSERT(MBED_CONF_APP_NW_INACTIVE_WINDOW_MIN_MS <= NETWORK_INACTIVE_WINDOW_MS,
+                   "nw-inactive-window-min-ms in mbed_app.json exceeds the default window");
+MBED_STATIC_ASSERT(MBED_CONF_APP_NW_INACTIVE_WINDOW_MAX_MS >= NETWORK_INACTIVE_WINDOW_MS,
+                   "nw-inactive-window-max-ms in mbed_app.json is below the default window");
+MBED_STATIC_ASSERT(MBED_CONF_APP_NW_SUSPEND_SEARCH_MS >= (MBED_CONF_APP_NW_INACTIVE_WINDOW_MAX_MS * NW_INACTIVITY_RATIO),
+                   "nw-suspend-search-ms in mbed_app.json is shorter than the longest inactivity interval");
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Written by the sleep thread only, read atomically by the HTTP server. */
+static nw_inactivity_info_t nw_inactivity = {
+    NETWORK_INACTIVE_INTERVAL_MS,
+    NETWORK_INACTIVE_WINDOW_MS,
+    0,
+    0
+};
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: nw_inactivity_ewma
+ ******************************************************************************
+ * Summary:
+ *   This function adds a sample to an exponentially weighted moving average.
+ *   The first sample initializes the average.
+ *
+ * Parameters:
+ *   average: Current average, or 0 if there is no sample yet.
+ *   sample: New sample.
+ *
+ * Return:
+ *   uint32_t: New average.
+ *
+ *****************************************************************************/
+static uint32_t nw_inactivity_ewma(uint32_t average, uint32_t sample)
+{
+    int64_t delta = (int64_t)sample - (int64_t)average;
+
+    if (0 == average)
+    {
+        return sample;
+    }
+
+    return (uint32_t)((int64_t)average + (delta / (1 << NW_INACTIVITY_EWMA_SHIFT)));
+}
+
+/******************************************************************************
+ * Function Name: nw_inactivity_get_window
+ ******************************************************************************
+ * Summary:
+ *   This function returns the inactivity interval and window to pass to the
+ *   next wait_net_suspend() call.
+ *
+ * Parameters:
+ *   interval_ms: Pointer that receives the interval in milliseconds.
+ *   window_ms: Pointer that receives the window in milliseconds.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void nw_inactivity_get_window(uint32_t *interval_ms, uint32_t *window_ms)
+{
+    *interval_ms = core_util_atomic_load_u32(&nw_inactivity.interval_ms);
+    *window_ms   = core_util_atomic_load_u32(&nw_inactivity.window_ms);
+}
+
+/******************************************************************************
+ * Function Name: nw_inactivity_set_window
+ ******************************************************************************
+ * Summary:
+ *   This function stores a new inactivity window, kept between
+ *   nw-inactive-window-min-ms and nw-inactive-window-max-ms, and the
+ *   interval that goes with it.
+ *
+ * Parameters:
+ *   window: New window in milliseconds.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+#if MBED_CONF_APP_NW_INACTIVE_ADAPTIVE
+static void nw_inactivity_set_window(uint32_t window)
+{
+    if (window < MBED_CONF_APP_NW_INACTIVE_WINDOW_MIN_MS)
+    {
+        window = MBED_CONF_APP_NW_INACTIVE_WINDOW_MIN_MS;
+    }
+    else if (window > MBED_CONF_APP_NW_INACTIVE_WINDOW_MAX_MS)
+    {
+        window = MBED_CONF_APP_NW_INACTIVE_WINDOW_MAX_MS;
+    }
+
+    core_util_atomic_store_u32(&nw_inactivity.window_ms, window);
+    core_util_atomic_store_u32(&nw_inactivity.interval_ms, window * NW_INACTIVITY_RATIO);
+}
+#endif /* #if MBED_CONF_APP_NW_INACTIVE_ADAPTIVE */
+
+/******************************************************************************
+ * Function Name: nw_inactivity_update
+ ******************************************************************************
+ * Summary:
+ *   This function adapts the inactivity window to the traffic seen during a
+ *   suspend. A suspend shorter than nw-suspend-break-even-ms does not pay
+ *   off, so the window doubles to skip lulls that short, unless finding a
+ *   window already takes longer than the break-even time on average; then
+ *   the window is held, as a longer window would keep the stack up even
+ *   longer. A suspend that pays off shrinks the window by a quarter, so that
+ *   the stack is suspended sooner, once suspends pay off on average too.
+ *   The window is kept between nw-inactive-window-min-ms and
+ *   nw-inactive-window-max-ms.
+ *
+ * Parameters:
+ *   awake_wait_ms: Time spent looking for an inactive window before the
+ *     network stack was suspended, over all the intervals watched.
+ *   idle_gap_ms: Time the network stack stayed suspended.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void nw_inactivity_update(uint32_t awake_wait_ms, uint32_t idle_gap_ms)
+{
+    uint32_t idle_gap_ewma = nw_inactivity_ewma(nw_inactivity.idle_gap_ewma_ms, idle_gap_ms);
+    uint32_t awake_wait_ewma = nw_inactivity_ewma(nw_inactivity.awake_wait_ewma_ms, awake_wait_ms);
+#if MBED_CONF_APP_NW_INACTIVE_ADAPTIVE
+    uint32_t window = nw_inactivity.window_ms;
+#endif /* #if MBED_CONF_APP_NW_INACTIVE_ADAPTIVE */
+
+    core_util_atomic_store_u32(&nw_inactivity.idle_gap_ewma_ms, idle_gap_ewma);
+    core_util_atomic_store_u32(&nw_inactivity.awake_wait_ewma_ms, awake_wait_ewma);
+
+#if MBED_CONF_APP_NW_INACTIVE_ADAPTIVE
+    if (idle_gap_ms < MBED_CONF_APP_NW_SUSPEND_BREAK_EVEN_MS)
+    {
+        if (awake_wait_ewma < MBED_CONF_APP_NW_SUSPEND_BREAK_EVEN_MS)
+        {
+            nw_inactivity_set_window(window * 2);
+        }
+    }
+    else if (idle_gap_ewma >= MBED_CONF_APP_NW_SUSPEND_BREAK_EVEN_MS)
+    {
+        nw_inactivity_set_window(window - (window / 4));
+    }
+#endif /* #if MBED_CONF_APP_NW_INACTIVE_ADAPTIVE */
+}
+
+/******************************************************************************
+ * Function Name: nw_inactivity_timeout
+ ******************************************************************************
+ * Summary:
+ *   This function adapts the inactivity window after a wait_net_suspend()
+ *   call that found no inactive window in its inactivity interval. Once the
+ *   search for the current sleep request has taken nw-suspend-break-even-ms,
+ *   the window is longer than the lulls of the traffic, so it shrinks by a
+ *   quarter. A shorter burst of traffic leaves the window alone. The time
+ *   spent looking is counted once the stack is suspended, by
+ *   nw_inactivity_update().
+ *
+ * Parameters:
+ *   search_ms: Time spent looking for an inactive window since the sleep
+ *     request.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void nw_inactivity_timeout(uint32_t search_ms)
+{
+#if MBED_CONF_APP_NW_INACTIVE_ADAPTIVE
+    if (search_ms >= MBED_CONF_APP_NW_SUSPEND_BREAK_EVEN_MS)
+    {
+        nw_inactivity_set_window(nw_inactivity.window_ms - (nw_inactivity.window_ms / 4));
+    }
+#else
+    (void)search_ms;
+#endif /* #if MBED_CONF_APP_NW_INACTIVE_ADAPTIVE */
+}
+
+/******************************************************************************
+ * Function Name: nw_inactivity_get_info
+ ******************************************************************************
+ * Summary:
+ *   This function takes a snapshot of the inactivity window and the traffic
+ *   statistics it is derived from.
+ *
+ * Parameters:
+ *   info: Pointer to the structure that receives the snapshot.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void nw_inactivity_get_info(nw_inactivity_info_t *info)
+{
+    info->interval_ms        = core_util_atomic_load_u32(&nw_inactivity.interval_ms);
+    info->window_ms          = core_util_atomic_load_u32(&nw_inactivity.window_ms);
+    info->idle_gap_ewma_ms   = core_util_atomic_load_u32(&nw_inactivity.idle_gap_ewma_ms);
+    info->awake_wait_ewma_ms = core_util_atomic_load_u32(&nw_inactivity.awake_wait_ewma_ms);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,100 @@
+/******************************************************************************
+ * File Name: nw_inactivity.h
+ *
+ * Description:
+ *   This file contains the macros, type definitions and function
+ *   declarations for the adaptive network inactivity window defined in
+ *   nw_inactivity.cpp file.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef NW_INACTIVITY_H
+#define NW_INACTIVITY_H
+
+#include "mbed.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+/* This macro specifies the interval in milliseconds that the device monitors
+ * the network for inactivity. If the network is inactive for duration lesser
+ * than the inactive window in this interval, the MCU does not suspend the
+ * network stack and informs the calling function that the MCU wait period
+ * timed out while waiting for network to become inactive. The adaptive
+ * window starts from these values and keeps the same interval to window
+ * ratio. It can be set at build time, for example to try other values in
+ * the host sleep simulator.
+ */
+#ifndef NETWORK_INACTIVE_INTERVAL_MS
+#define NETWORK_INACTIVE_INTERVAL_MS   (500)
+#endif /* #ifndef NETWORK_INACTIVE_INTERVAL_MS */
+
+/* This macro specifies the continuous duration in milliseconds for which the
+ * network has to be inactive. If the network is inactive for this duaration,
+ * the MCU will suspend the network stack. Now, the MCU will not need to service
+ * the network timers which allows it to stay longer in sleep/deepsleep.
+ * It can be set at build time as well.
+ */
+#ifndef NETWORK_INACTIVE_WINDOW_MS
+#define NETWORK_INACTIVE_WINDOW_MS     (250)
+#endif /* #ifndef NETWORK_INACTIVE_WINDOW_MS */
+
+/* Weight of a new sample in the moving averages, as a power of two:
+ * 3 gives each new sample a weight of 1/8.
+ */
+#define NW_INACTIVITY_EWMA_SHIFT       (3)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Inactivity window in use and the traffic statistics it is derived from. */
+typedef struct
+{
+    uint32_t interval_ms;        /* Interval passed to wait_net_suspend().     */
+    uint32_t window_ms;          /* Window passed to wait_net_suspend().       */
+    uint32_t idle_gap_ewma_ms;   /* Average time the stack stayed suspended.   */
+    uint32_t awake_wait_ewma_ms; /* Average time to find an inactive window.   */
+} nw_inactivity_info_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+void nw_inactivity_get_window(uint32_t *interval_ms, uint32_t *window_ms);
+void nw_inactivity_update(uint32_t awake_wait_ms, uint32_t idle_gap_ms);
+void nw_inactivity_timeout(uint32_t search_ms);
+void nw_inactivity_get_info(nw_inactivity_info_t *info);
+
+#endif /* #ifndef NW_INACTIVITY_H */
+
+
+/* [] END OF FILE */
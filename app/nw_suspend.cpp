@@ -0,0 +1,205 @@
+/******************************************************************************
+ * File Name: nw_suspend.cpp
+ *
+ * Description:
+ *   This file contains one cycle of the host network stack suspend: waiting for
+ *   a sleep request, suspending the network stack once the network is inactive,
+ *   and recording the statistics of the suspend once the stack has resumed.
+ *   main.cpp runs it in a loop on the target; the host sleep simulator runs it
+ *   against a packet trace.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "network_activity_handler.h"
+#include "http_webserver_config.h"
+#include "nw_suspend.h"
+#include "app_stats.h"
+#include "host_sleep.h"
+#include "nw_inactivity.h"
+#include "wake_reason.h"
+
+/******************************************************************************
+ *                              EXTERNS
+ *****************************************************************************/
+/* Time in microseconds spent in deep sleep with the network stack suspended,
+ * maintained by the LPA network activity handler.
+ */
+extern us_timestamp_t cy_dsleep_nw_suspend_time;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: nw_suspend_run
+ ******************************************************************************
+ * Summary:
+ *   This function waits for a sleep request raised by the HTTP user request
+ *   to click on 'Simulate Host Sleep' web button. Once the response to the
+ *   request has been sent, it suspends the host network stack, which allows
+ *   the Host MCU to go to deep-sleep. It returns once the network stack has
+ *   resumed, or without a suspend if no inactive window is found in
+ *   nw-suspend-search-ms or wait_net_suspend() fails.
+ *
+ * Parameters:
+ *   wifi: A pointer to WLAN interface whose emac activity is being monitored.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void nw_suspend_run(WhdSTAInterface *wifi)
+{
+    int32_t result = ST_SUCCESS;
+    bool searching = true;
+    bool suspended = false;
+    uint32_t interval_ms = 0;
+    uint32_t window_ms = 0;
+    uint32_t search_ms = 0;
+    uint32_t idle_gap_ms = 0;
+    uint32_t awake_wait_ms = 0;
+    uint64_t suspend_ms = 0;
+    uint64_t wake_ms = 0;
+    host_sleep_info_t sleep_info;
+    us_timestamp_t dsleep_start = 0;
+    Kernel::Clock::time_point search_start;
+
+    /* Wait for the HTTP user request to put the host in deep sleep. */
+    host_sleep_wait_request();
+    host_sleep_get_info(&sleep_info);
+
+    /* Let the HTTP server send the response to the sleep request and the
+     * client acknowledge it, then close the idle HTTP connections so that
+     * they do not keep the network active.
+     */
+    app_http_server_drain_responses(MBED_CONF_APP_HTTP_DRAIN_TIMEOUT_MS);
+    app_http_server_evict_connections();
+    wake_reason_suspending();
+    host_sleep_searching();
+
+    /* Configures an emac activity callback to the Wi-Fi interface
+     * and suspends the network stack if the network is inactive for
+     * a duration of window_ms inside an interval of interval_ms. The
+     * callback is used to signal the presence/absence of network
+     * activity to resume/suspend the network stack. Once suspended,
+     * the stack stays suspended until there is network activity.
+     */
+    dsleep_start = cy_dsleep_nw_suspend_time;
+    search_start = Kernel::Clock::now();
+    do
+    {
+        nw_inactivity_get_window(&interval_ms, &window_ms);
+
+        app_stats_nw_suspend_attempt();
+        wake_reason_watch(window_ms);
+        result = wait_net_suspend(wifi,
+                                  osWaitForever,
+                                  interval_ms,
+                                  window_ms);
+        search_ms = (Kernel::Clock::now() - search_start).count();
+
+        switch (result)
+        {
+            case ST_SUCCESS:
+                /* Suspended, and resumed by network activity. */
+            case ST_WAIT_TIMEOUT_EXPIRED:
+                /* Suspended, and resumed after the wait time. It does not
+                 * expire with osWaitForever, but the stack was suspended.
+                 */
+                suspended = true;
+                searching = false;
+                break;
+
+            case ST_WAIT_INACTIVITY_TIMEOUT_EXPIRED:
+                /* No inactive window in this interval: the window may be
+                 * too long for the traffic. Watch the next interval, until
+                 * nw-suspend-search-ms runs out.
+                 */
+                nw_inactivity_timeout(search_ms);
+                if (search_ms >= MBED_CONF_APP_NW_SUSPEND_SEARCH_MS)
+                {
+                    APP_INFO(("No inactive network window in %lu ms, "
+                              "network stack not suspended\n", (unsigned long)search_ms));
+                    searching = false;
+                }
+                break;
+
+            case ST_WAIT_ABORTED:
+            case ST_BAD_ARGS:
+            case ST_BAD_STATE:
+            default:
+                ERR_INFO(("Failed to suspend the network stack: %ld\n", (long)result));
+                searching = false;
+                break;
+        }
+    } while (searching);
+
+    if (suspended)
+    {
+        app_stats_nw_suspended();
+        wake_ms = wake_reason_resumed();
+
+        /* wait_net_suspend() does not report when the stack was
+         * suspended. The deep sleep time with the stack suspended is
+         * taken as the idle gap, and the rest of the search, over all
+         * the intervals watched, as the time it took to find an
+         * inactive window.
+         */
+        idle_gap_ms = (uint32_t)((cy_dsleep_nw_suspend_time - dsleep_start) / 1000);
+        awake_wait_ms = (search_ms > idle_gap_ms) ? (search_ms - idle_gap_ms) : 0;
+        suspend_ms = search_start.time_since_epoch().count() + awake_wait_ms;
+        host_sleep_suspended(suspend_ms, wake_ms);
+        nw_inactivity_update(awake_wait_ms, idle_gap_ms);
+        app_stats_record(APP_STATS_HIST_SLEEP_EPISODE, idle_gap_ms);
+
+        /* The suspend latency runs from the sleep request, through the
+         * response drain and the search for an inactive window, to the
+         * suspend of the stack.
+         */
+        app_stats_record(APP_STATS_HIST_SUSPEND_LATENCY,
+                         (uint32_t)(suspend_ms -
+                                    sleep_info.entered_ms[HOST_SLEEP_STATE_PENDING_SUSPEND]));
+    }
+    else
+    {
+        app_stats_nw_suspend_abandoned();
+    }
+
+    /* Back to AWAKE, or to PENDING_SUSPEND if a sleep request arrived
+     * once the search had started; the next wait then returns at once.
+     */
+    host_sleep_resumed();
+}
+
+
+/* [] END OF FILE */
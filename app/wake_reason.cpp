@@ -0,0 +1,583 @@
+/******************************************************************************
+ * File Name: wake_reason.cpp
+ *
+ * Description:
+ *   This file contains the attribution of the resumes of the suspended
+ *   network stack to a wake reason. The LPA network activity handler does
+ *   not pass the frame that resumed the stack to the application, so the
+ *   input and link output functions of the default lwIP interface are
+ *   wrapped instead. While wait_net_suspend() looks for an inactive window,
+ *   the first frame received after a whole window without a frame sent or
+ *   received is the one that resumed the stack; it is classified by
+ *   EtherType, destination address, IP protocol and destination port. A
+ *   resume without such a frame is attributed to a timer. The time the
+ *   stack stays up until the next suspend is added to the reason of the
+ *   resume.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "wake_reason.h"
+#include "app_stats.h"
+#include "host_sleep.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcpip.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+#define WAKE_ETH_HEADER_LEN       (14)
+#define WAKE_ETH_VLAN_TAG_LEN     (4)
+#define WAKE_ETH_TYPE_OFFSET      (12)
+#define WAKE_ETH_TYPE_IPV4        (0x0800)
+#define WAKE_ETH_TYPE_ARP         (0x0806)
+#define WAKE_ETH_TYPE_VLAN        (0x8100)
+#define WAKE_ETH_TYPE_IPV6        (0x86DD)
+
+#define WAKE_IPV4_HEADER_MIN_LEN  (20)
+#define WAKE_IPV4_FRAGMENT_MASK   (0x1FFF)
+#define WAKE_IPV6_HEADER_LEN      (40)
+
+#define WAKE_IP_PROTO_ICMP        (1)
+#define WAKE_IP_PROTO_ICMPV6      (58)
+#define WAKE_ICMP_ECHO_REQUEST    (8)
+#define WAKE_ICMPV6_ECHO_REQUEST  (128)
+
+/* Ports of a wake frame are counted by protocol and destination port. */
+#define WAKE_PORT_KEY(protocol, port)  (((uint32_t)(protocol) << 16) | (port))
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Wake counters and awake times, accessed atomically. The ports are kept
+ * as WAKE_PORT_KEY() keys, 0 for an unused entry, next to their counters.
+ */
+static uint32_t wake_counts[WAKE_REASON_MAX];
+static uint64_t wake_awake_ms[WAKE_REASON_MAX];
+static uint32_t wake_port_keys[WAKE_REASON_PORTS];
+static uint32_t wake_port_wakes[WAKE_REASON_PORTS];
+
+/* Functions of the default lwIP interface wrapped by this module. */
+static netif_input_fn wake_netif_input;
+static netif_linkoutput_fn wake_netif_linkoutput;
+
+/* Whether the frames are watched for the one that resumes the stack, the
+ * inactivity window of the current wait_net_suspend() call, and the time
+ * of the last frame sent or received since the call.
+ */
+static volatile bool wake_watching;
+static volatile uint32_t wake_window_ms;
+static volatile uint64_t wake_activity_ms;
+
+/* Classification and arrival time of the frame that resumed the stack, if
+ * one was seen.
+ */
+static volatile bool wake_captured;
+static volatile uint64_t wake_frame_ms;
+static volatile uint32_t wake_frame_reason;
+static volatile uint32_t wake_frame_port_key;
+
+/* Time of the last resume in milliseconds since startup. */
+static volatile uint64_t wake_resume_ms;
+
+/* Whether the network stack was resumed and not suspended again since. */
+static volatile bool wake_awake;
+
+/* Reason the last resume was attributed to. */
+static volatile uint32_t wake_reason = WAKE_REASON_TIMER;
+
+static const char* const wake_reason_names[WAKE_REASON_MAX] = {
+    "arp",
+    "broadcast",
+    "ping",
+    "tcp",
+    "udp",
+    "other",
+    "timer"
+};
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: wake_reason_now_ms
+ ******************************************************************************
+ * Summary:
+ *   This function returns the time since startup.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   uint64_t: Time in milliseconds since startup.
+ *
+ *****************************************************************************/
+static uint64_t wake_reason_now_ms(void)
+{
+    return Kernel::Clock::now().time_since_epoch().count();
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_read_u16
+ ******************************************************************************
+ * Summary:
+ *   This function reads a 16-bit field in network byte order.
+ *
+ * Parameters:
+ *   field: Pointer to the first byte of the field.
+ *
+ * Return:
+ *   uint16_t: Value of the field.
+ *
+ *****************************************************************************/
+static uint16_t wake_reason_read_u16(const uint8_t *field)
+{
+    return (uint16_t)((field[0] << 8) | field[1]);
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_classify
+ ******************************************************************************
+ * Summary:
+ *   This function classifies an Ethernet frame. ARP comes first, then any
+ *   other frame to a broadcast or multicast address. Unicast IPv4 and IPv6
+ *   frames are told apart by IP protocol: echo requests are pings, and TCP
+ *   and UDP frames return their destination port. IPv6 extension headers
+ *   and IPv4 fragments after the first are not followed.
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the frame, at the Ethernet header.
+ *   length: Number of bytes of the frame available.
+ *   port: Pointer that receives the destination port of a TCP or UDP
+ *     frame, or 0.
+ *
+ * Return:
+ *   wake_reason_t: Wake reason of the frame. WAKE_REASON_OTHER if the frame
+ *     is too short to tell.
+ *
+ *****************************************************************************/
+wake_reason_t wake_reason_classify(const uint8_t *frame, uint32_t length, uint16_t *port)
+{
+    uint32_t offset = WAKE_ETH_HEADER_LEN;
+    uint16_t type;
+    uint8_t protocol;
+    uint8_t echo_request;
+
+    *port = 0;
+    if (length < WAKE_ETH_HEADER_LEN)
+    {
+        return WAKE_REASON_OTHER;
+    }
+
+    type = wake_reason_read_u16(&frame[WAKE_ETH_TYPE_OFFSET]);
+    if ((WAKE_ETH_TYPE_VLAN == type) && (length >= (offset + WAKE_ETH_VLAN_TAG_LEN)))
+    {
+        type = wake_reason_read_u16(&frame[WAKE_ETH_TYPE_OFFSET + WAKE_ETH_VLAN_TAG_LEN]);
+        offset += WAKE_ETH_VLAN_TAG_LEN;
+    }
+
+    if (WAKE_ETH_TYPE_ARP == type)
+    {
+        return WAKE_REASON_ARP;
+    }
+
+    /* Group bit of the destination address. */
+    if (0 != (frame[0] & 0x01))
+    {
+        return WAKE_REASON_BROADCAST;
+    }
+
+    if ((WAKE_ETH_TYPE_IPV4 == type) && (length >= (offset + WAKE_IPV4_HEADER_MIN_LEN)))
+    {
+        if (0 != (wake_reason_read_u16(&frame[offset + 6]) & WAKE_IPV4_FRAGMENT_MASK))
+        {
+            return WAKE_REASON_OTHER;
+        }
+        protocol = frame[offset + 9];
+        echo_request = (WAKE_IP_PROTO_ICMP == protocol) ? WAKE_ICMP_ECHO_REQUEST : 0;
+        offset += (frame[offset] & 0x0F) * 4;
+    }
+    else if ((WAKE_ETH_TYPE_IPV6 == type) && (length >= (offset + WAKE_IPV6_HEADER_LEN)))
+    {
+        protocol = frame[offset + 6];
+        echo_request = (WAKE_IP_PROTO_ICMPV6 == protocol) ? WAKE_ICMPV6_ECHO_REQUEST : 0;
+        offset += WAKE_IPV6_HEADER_LEN;
+    }
+    else
+    {
+        return WAKE_REASON_OTHER;
+    }
+
+    /* The ICMP type, or the source and destination ports. */
+    if (length < (offset + 4))
+    {
+        return WAKE_REASON_OTHER;
+    }
+
+    if (0 != echo_request)
+    {
+        return (echo_request == frame[offset]) ? WAKE_REASON_PING : WAKE_REASON_OTHER;
+    }
+    if ((WAKE_REASON_IP_PROTO_TCP == protocol) || (WAKE_REASON_IP_PROTO_UDP == protocol))
+    {
+        *port = wake_reason_read_u16(&frame[offset + 2]);
+        return (WAKE_REASON_IP_PROTO_TCP == protocol) ? WAKE_REASON_TCP : WAKE_REASON_UDP;
+    }
+
+    return WAKE_REASON_OTHER;
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_frame
+ ******************************************************************************
+ * Summary:
+ *   This function is called for each frame received while the frames are
+ *   watched. A frame that follows a whole inactivity window without a frame
+ *   sent or received resumed the suspended stack: it is classified, the
+ *   host sleep state machine moves to RESUMING, and the watch ends. Any
+ *   other frame restarts the window.
+ *
+ * Parameters:
+ *   p: Pointer to the received frame.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void wake_reason_frame(struct pbuf *p)
+{
+    uint8_t frame[WAKE_REASON_FRAME_LEN];
+    uint64_t now_ms = wake_reason_now_ms();
+    uint64_t activity_ms = core_util_atomic_load_u64(&wake_activity_ms);
+    uint32_t window_ms = core_util_atomic_load_u32(&wake_window_ms);
+    uint16_t length;
+    uint16_t port;
+    uint32_t key = 0;
+    wake_reason_t reason;
+    bool expected = true;
+
+    if ((now_ms - activity_ms) < window_ms)
+    {
+        core_util_atomic_store_u64(&wake_activity_ms, now_ms);
+        return;
+    }
+
+    if (!core_util_atomic_cas_bool(&wake_watching, &expected, false))
+    {
+        return;
+    }
+
+    length = pbuf_copy_partial(p, frame, sizeof(frame), 0);
+    reason = wake_reason_classify(frame, length, &port);
+    if (WAKE_REASON_TCP == reason)
+    {
+        key = WAKE_PORT_KEY(WAKE_REASON_IP_PROTO_TCP, port);
+    }
+    else if (WAKE_REASON_UDP == reason)
+    {
+        key = WAKE_PORT_KEY(WAKE_REASON_IP_PROTO_UDP, port);
+    }
+
+    core_util_atomic_store_u32(&wake_frame_reason, reason);
+    core_util_atomic_store_u32(&wake_frame_port_key, key);
+    core_util_atomic_store_u64(&wake_frame_ms, now_ms);
+    core_util_atomic_store_bool(&wake_captured, true);
+
+    /* The LPA suspended the stack once the window had passed. */
+    host_sleep_resuming(activity_ms + window_ms, now_ms);
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_input
+ ******************************************************************************
+ * Summary:
+ *   This function wraps the input function of the default lwIP interface.
+ *   It is called by the WLAN driver for each received frame.
+ *
+ * Parameters:
+ *   p: Pointer to the received frame.
+ *   inp: Pointer to the interface the frame was received on.
+ *
+ * Return:
+ *   err_t: Result of the wrapped input function.
+ *
+ *****************************************************************************/
+static err_t wake_reason_input(struct pbuf *p, struct netif *inp)
+{
+    if (core_util_atomic_load_bool(&wake_watching))
+    {
+        wake_reason_frame(p);
+    }
+
+    return wake_netif_input(p, inp);
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_linkoutput
+ ******************************************************************************
+ * Summary:
+ *   This function wraps the link output function of the default lwIP
+ *   interface. A frame sent restarts the inactivity window, as it does for
+ *   the LPA.
+ *
+ * Parameters:
+ *   netif: Pointer to the interface the frame is sent on.
+ *   p: Pointer to the frame to send.
+ *
+ * Return:
+ *   err_t: Result of the wrapped link output function.
+ *
+ *****************************************************************************/
+static err_t wake_reason_linkoutput(struct netif *netif, struct pbuf *p)
+{
+    if (core_util_atomic_load_bool(&wake_watching))
+    {
+        core_util_atomic_store_u64(&wake_activity_ms, wake_reason_now_ms());
+    }
+
+    return wake_netif_linkoutput(netif, p);
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_init
+ ******************************************************************************
+ * Summary:
+ *   This function wraps the input and link output functions of the default
+ *   lwIP interface, so that the frame that resumes the suspended network
+ *   stack can be classified. It is called once the interface is up.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void wake_reason_init(void)
+{
+    LOCK_TCPIP_CORE();
+    if ((NULL != netif_default) && (NULL == wake_netif_input))
+    {
+        wake_netif_input = netif_default->input;
+        wake_netif_linkoutput = netif_default->linkoutput;
+        netif_default->input = wake_reason_input;
+        netif_default->linkoutput = wake_reason_linkoutput;
+    }
+    UNLOCK_TCPIP_CORE();
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_watch
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the sleep thread before each call to
+ *   wait_net_suspend(). The inactivity window starts with the call, as it
+ *   does for the LPA, and the frames are watched for the one that resumes
+ *   the stack.
+ *
+ * Parameters:
+ *   window_ms: Inactivity window passed to wait_net_suspend().
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void wake_reason_watch(uint32_t window_ms)
+{
+    core_util_atomic_store_bool(&wake_captured, false);
+    core_util_atomic_store_u32(&wake_window_ms, window_ms);
+    core_util_atomic_store_u64(&wake_activity_ms, wake_reason_now_ms());
+    core_util_atomic_store_bool(&wake_watching, true);
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_count_port
+ ******************************************************************************
+ * Summary:
+ *   This function counts a wake by a unicast TCP or UDP frame under its
+ *   protocol and destination port, if the port is already counted or an
+ *   entry is free.
+ *
+ * Parameters:
+ *   key: WAKE_PORT_KEY() of the frame.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void wake_reason_count_port(uint32_t key)
+{
+    uint32_t entry;
+
+    for (uint32_t i = 0; i < WAKE_REASON_PORTS; i++)
+    {
+        entry = core_util_atomic_load_u32(&wake_port_keys[i]);
+        if ((entry == key) || (0 == entry))
+        {
+            core_util_atomic_incr_u32(&wake_port_wakes[i], 1);
+            core_util_atomic_store_u32(&wake_port_keys[i], key);
+            return;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_resumed
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the sleep thread when wait_net_suspend()
+ *   returns after a suspend. The WLAN driver passes a frame to the stack
+ *   from a thread of higher priority than the sleep thread, right after it
+ *   reports the activity that resumes the stack, so the frame that resumed
+ *   the stack has been seen by then. The resume is attributed to the reason
+ *   of the frame, or to a timer if there was none. The time from the frame
+ *   to now, when the stack is ready again, is recorded as the resume
+ *   latency.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   uint64_t: Time of the frame that resumed the stack in milliseconds
+ *     since startup, or the current time if there was none.
+ *
+ *****************************************************************************/
+uint64_t wake_reason_resumed(void)
+{
+    uint32_t reason = WAKE_REASON_TIMER;
+    uint32_t key;
+    uint64_t now_ms = wake_reason_now_ms();
+    uint64_t wake_ms = now_ms;
+
+    core_util_atomic_store_bool(&wake_watching, false);
+    if (core_util_atomic_exchange_bool(&wake_captured, false))
+    {
+        wake_ms = core_util_atomic_load_u64(&wake_frame_ms);
+        app_stats_record(APP_STATS_HIST_RESUME_LATENCY, (uint32_t)(now_ms - wake_ms));
+        reason = core_util_atomic_load_u32(&wake_frame_reason);
+        key = core_util_atomic_load_u32(&wake_frame_port_key);
+        if (0 != key)
+        {
+            wake_reason_count_port(key);
+        }
+    }
+
+    core_util_atomic_incr_u32(&wake_counts[reason], 1);
+    core_util_atomic_store_u32(&wake_reason, reason);
+    core_util_atomic_store_u64(&wake_resume_ms, now_ms);
+    core_util_atomic_store_bool(&wake_awake, true);
+
+    return wake_ms;
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_suspending
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the sleep thread before it suspends the
+ *   network stack again. The time the stack stayed up since the resume is
+ *   added to the reason of the resume.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void wake_reason_suspending(void)
+{
+    uint32_t reason;
+    uint64_t awake_ms;
+
+    if (!core_util_atomic_exchange_bool(&wake_awake, false))
+    {
+        return;
+    }
+
+    reason = core_util_atomic_load_u32(&wake_reason);
+    awake_ms = wake_reason_now_ms() - core_util_atomic_load_u64(&wake_resume_ms);
+    core_util_atomic_incr_u64(&wake_awake_ms[reason], awake_ms);
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_get_stats
+ ******************************************************************************
+ * Summary:
+ *   This function takes a snapshot of the wake counters and awake times.
+ *
+ * Parameters:
+ *   stats: Pointer to the structure that receives the counters.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void wake_reason_get_stats(wake_reason_stats_t *stats)
+{
+    uint32_t key;
+
+    for (uint32_t i = 0; i < WAKE_REASON_MAX; i++)
+    {
+        stats->wakes[i]    = core_util_atomic_load_u32(&wake_counts[i]);
+        stats->awake_ms[i] = core_util_atomic_load_u64(&wake_awake_ms[i]);
+    }
+    for (uint32_t i = 0; i < WAKE_REASON_PORTS; i++)
+    {
+        key = core_util_atomic_load_u32(&wake_port_keys[i]);
+        stats->ports[i].protocol = (uint8_t)(key >> 16);
+        stats->ports[i].port     = (uint16_t)key;
+        stats->ports[i].wakes    = (0 == key) ? 0 : core_util_atomic_load_u32(&wake_port_wakes[i]);
+    }
+}
+
+/******************************************************************************
+ * Function Name: wake_reason_name
+ ******************************************************************************
+ * Summary:
+ *   This function returns the name of a wake reason.
+ *
+ * Parameters:
+ *   reason: Wake reason.
+ *
+ * Return:
+ *   const char*: Name of the wake reason.
+ *
+ *****************************************************************************/
+const char* wake_reason_name(wake_reason_t reason)
+{
+    return (reason < WAKE_REASON_MAX) ? wake_reason_names[reason] : "unknown";
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * File Name: wake_reason.h
+ *
+ * Description:
+ *   This file contains the macros, type definitions and function
+ *   declarations for the wake reason attribution defined in wake_reason.cpp
+ *   file.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef WAKE_REASON_H
+#define WAKE_REASON_H
+
+#include "mbed.h"
+
+/******************************************************************************
+ *                                  MACROS
+ *****************************************************************************/
+/* Bytes of the wake frame read for its classification: the Ethernet header
+ * with a VLAN tag, the longest IPv4 header and the ports of TCP or UDP.
+ */
+#define WAKE_REASON_FRAME_LEN   (96)
+
+/* Destination ports of unicast TCP and UDP wake frames counted separately.
+ * Wake frames for further ports are only counted by protocol.
+ */
+#define WAKE_REASON_PORTS       (8)
+
+#define WAKE_REASON_IP_PROTO_TCP  (6)
+#define WAKE_REASON_IP_PROTO_UDP  (17)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+typedef enum
+{
+    WAKE_REASON_ARP,        /* ARP request or reply.                         */
+    WAKE_REASON_BROADCAST,  /* Any other broadcast or multicast frame.       */
+    WAKE_REASON_PING,       /* Unicast ICMP or ICMPv6 echo request.          */
+    WAKE_REASON_TCP,        /* Unicast TCP segment.                          */
+    WAKE_REASON_UDP,        /* Unicast UDP datagram.                         */
+    WAKE_REASON_OTHER,      /* Any other unicast frame.                      */
+    WAKE_REASON_TIMER,      /* Resumed without a frame.                      */
+    WAKE_REASON_MAX
+} wake_reason_t;
+
+/* Wakes by a unicast TCP or UDP frame to one destination port. */
+typedef struct
+{
+    uint8_t  protocol;  /* WAKE_REASON_IP_PROTO_TCP or _UDP, 0 if unused. */
+    uint16_t port;
+    uint32_t wakes;
+} wake_reason_port_t;
+
+/* Resumes of the suspended network stack and the time the stack stayed up
+ * after them, by wake reason, since startup.
+ */
+typedef struct
+{
+    uint32_t           wakes[WAKE_REASON_MAX];
+    uint64_t           awake_ms[WAKE_REASON_MAX];
+    wake_reason_port_t ports[WAKE_REASON_PORTS];
+} wake_reason_stats_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+void wake_reason_init(void);
+void wake_reason_watch(uint32_t window_ms);
+uint64_t wake_reason_resumed(void);
+void wake_reason_suspending(void);
+wake_reason_t wake_reason_classify(const uint8_t *frame, uint32_t length, uint16_t *port);
+void wake_reason_get_stats(wake_reason_stats_t *stats);
+const char* wake_reason_name(wake_reason_t reason);
+
+#endif /* #ifndef WAKE_REASON_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Estimates the energy used by the kit from sleep statistics recorded from the
+/stats.json resource of the HTTP server.
+
+This is the model of app/energy_model.cpp: the time since startup is split
+into the power states of the PSoC 6 MCU and of the WLAN device, and each
+state is weighted with its supply current. The currents, supply voltage and
+battery capacity are read from mbed_app.json for the given target, so the
+estimate matches the one the kit reports for the same statistics.
+
+The log holds one /stats.json document per line, for example recorded with:
+
+    while true; do curl -s http://<kit IP>/stats.json; echo; sleep 60; done > stats.log
+
+Run this script from the repository root:
+
+    python scripts/energy_estimate.py CY8CPROTO_062_4343W stats.log
+
+Every line of the log is printed with its estimate. Lines that are not JSON
+documents, or that lack the MCU sleep statistics, are skipped.
+"""
+
+import json
+import os
+import sys
+
+ROOT_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), os.pardir))
+MBED_APP_JSON = os.path.join(ROOT_DIR, "mbed_app.json")
+
+# Configuration parameters of the model in mbed_app.json.
+PARAMETERS = [
+    "energy-mcu-active-ua",
+    "energy-mcu-sleep-ua",
+    "energy-mcu-deepsleep-ua",
+    "energy-wlan-awake-ua",
+    "energy-wlan-offload-ua",
+    "energy-supply-mv",
+    "energy-battery-mah",
+]
+
+
+def load_parameters(target):
+    """Returns the model parameters for the target, as set in mbed_app.json."""
+    with open(MBED_APP_JSON, "r") as f:
+        app = json.load(f)
+
+    params = {name: app["config"][name]["value"] for name in PARAMETERS}
+    for key in ("*", target):
+        overrides = app.get("target_overrides", {}).get(key, {})
+        for name in PARAMETERS:
+            if name in overrides:
+                params[name] = overrides[name]
+            elif "app." + name in overrides:
+                params[name] = overrides["app." + name]
+    return params
+
+
+def estimate(params, stats):
+    """Returns (average current in uA, mJ per hour, battery life in hours) for
+    one /stats.json document, or None if it cannot be estimated."""
+    try:
+        uptime_us = stats["uptime"]
+        sleep_us = stats["sleep"]
+        deepsleep_us = stats["deepsleep"]
+        suspended_us = stats["nw_suspend_deepsleep"]
+    except KeyError:
+        return None
+
+    if (uptime_us == 0 or (sleep_us + deepsleep_us) > uptime_us
+            or suspended_us > uptime_us):
+        return None
+    active_us = uptime_us - sleep_us - deepsleep_us
+
+    # Integer arithmetic as on the kit, so the results match exactly.
+    avg_ua = (params["energy-mcu-active-ua"] * active_us // uptime_us +
+              params["energy-mcu-sleep-ua"] * sleep_us // uptime_us +
+              params["energy-mcu-deepsleep-ua"] * deepsleep_us // uptime_us +
+              params["energy-wlan-awake-ua"] * (uptime_us - suspended_us) // uptime_us +
+              params["energy-wlan-offload-ua"] * suspended_us // uptime_us)
+    avg_ua = max(avg_ua, 1)
+
+    mj_per_hour = avg_ua * params["energy-supply-mv"] * 36 // 10000
+    battery_hours = params["energy-battery-mah"] * 1000 // avg_ua
+    return avg_ua, mj_per_hour, battery_hours
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write("usage: %s <target> <stats log>\n" % sys.argv[0])
+        return 1
+
+    params = load_parameters(sys.argv[1])
+
+    print("%12s %12s %12s %12s" % ("uptime(s)", "current(uA)", "mJ/hour", "battery(h)"))
+    with open(sys.argv[2], "r") as f:
+        for line in f:
+            try:
+                stats = json.loads(line)
+            except ValueError:
+                continue
+
+            result = estimate(params, stats)
+            if result is None:
+                continue
+
+            print("%12d %12d %12d %12d" % ((stats["uptime"] // 1000000,) + result))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * File Name: bench_http_clients.cpp
+ *
+ * Description:
+ *   This file contains the benchmark of the HTTP pages as the number of
+ *   concurrent clients grows. For 1 to BENCH_MAX_CLIENTS clients, each client
+ *   requests a mix of pages through a stream whose writes take a fixed time,
+ *   as a client on the network does. The requests served per second, the
+ *   p50 and p99 service time, and the requests that found the response
+ *   buffers exhausted are reported. The library limits the connections to
+ *   http-max-sockets on the kit; here every client is served at once, so the
+ *   pool is what limits the clients.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "host_platform.h"
+#include "http_webserver_config.h"
+#include "http_response_pool.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define BENCH_MAX_CLIENTS     (16)
+#define BENCH_REQUESTS        (500)
+#define BENCH_WRITE_DELAY_US  (20)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+typedef struct
+{
+    std::vector<double> service_us;
+    uint32_t            exhausted;
+} bench_client_t;
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Pages a monitoring client polls, with the pool-backed /stats.json the most
+ * frequent.
+ */
+static const char *const bench_urls[] = { "/stats.json", "/stats.json", "/metrics", "/stats", "/" };
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void bench_client(uint32_t id, bench_client_t *client)
+{
+    for (uint32_t n = 0; n < BENCH_REQUESTS; n++)
+    {
+        const char *url = bench_urls[(id + n) % (sizeof(bench_urls) / sizeof(bench_urls[0]))];
+        cy_http_response_stream_t stream;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        cy_rslt_t result;
+
+        stream.write_delay_us = BENCH_WRITE_DELAY_US;
+        result = (cy_rslt_t)host_http_request(url, &stream, NULL);
+        client->service_us.push_back(std::chrono::duration<double, std::micro>(
+                                         std::chrono::steady_clock::now() - start).count());
+        if ((CY_RSLT_TYPE_ERROR == result) && stream.body.empty())
+        {
+            client->exhausted++;
+        }
+    }
+}
+
+static double bench_percentile(const std::vector<double> &sorted, double percentile)
+{
+    return sorted[(size_t)((percentile / 100.0) * (double)(sorted.size() - 1) + 0.5)];
+}
+
+int main(void)
+{
+    int saved_stdout;
+    int null_fd;
+
+    host_set_cpu_stats(3600000000ULL, 3000000000ULL, 500000000ULL, 2400000000ULL);
+    host_http_init();
+
+    printf("bench_http_clients: %u requests per client, %u us per stream write, "
+           "%u response buffers\n",
+           BENCH_REQUESTS, BENCH_WRITE_DELAY_US, (unsigned int)HTTP_RESPONSE_POOL_SIZE);
+    printf("%8s %14s %10s %10s %10s\n", "clients", "served/s", "p50(us)", "p99(us)", "exhausted");
+
+    for (uint32_t clients = 1; clients <= BENCH_MAX_CLIENTS; clients *= 2)
+    {
+        std::vector<bench_client_t> results(clients);
+        std::vector<std::thread> threads;
+        std::vector<double> service_us;
+        std::chrono::steady_clock::time_point start;
+        double elapsed_s;
+        uint32_t exhausted = 0;
+
+        /* The failed requests log an error; keep them out of the report. */
+        fflush(stdout);
+        saved_stdout = dup(STDOUT_FILENO);
+        null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < clients; i++)
+        {
+            results[i].exhausted = 0;
+            threads.push_back(std::thread(bench_client, i, &results[i]));
+        }
+        for (std::thread &t : threads)
+        {
+            t.join();
+        }
+        elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        fflush(stdout);
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+
+        for (const bench_client_t &client : results)
+        {
+            service_us.insert(service_us.end(), client.service_us.begin(), client.service_us.end());
+            exhausted += client.exhausted;
+        }
+        std::sort(service_us.begin(), service_us.end());
+
+        printf("%8u %14.0f %10.1f %10.1f %10u\n", clients,
+               (double)(service_us.size() - exhausted) / elapsed_s, bench_percentile(service_us, 50.0),
+               bench_percentile(service_us, 99.0), exhausted);
+    }
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
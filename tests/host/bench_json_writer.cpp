@@ -0,0 +1,133 @@
+/******************************************************************************
+ * File Name: bench_json_writer.cpp
+ *
+ * Description:
+ *   This file contains the benchmark of the JSON writer. It formats the
+ *   /stats.json document with the JSON writer and with the snprintf() "%llu"
+ *   formatting it replaced, and reports the time per document of each.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "json_writer.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define BENCH_ITERATIONS   (1000000)
+#define BENCH_BUF_LEN      (1024)
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Read through a volatile pointer so the values are not constant folded. */
+static volatile uint64_t bench_values[5] = {
+    3600123456ULL, 3000654321ULL, 500000001ULL, 2400000002ULL, 2399999999ULL
+};
+
+/* Keeps the output alive so the formatting is not optimized out. */
+static volatile uint32_t bench_sink;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static uint32_t bench_json_writer(char *buf)
+{
+    json_writer_t json;
+
+    json_writer_init(&json, buf, BENCH_BUF_LEN);
+    json_writer_begin_object(&json);
+    json_writer_add_uint64(&json, "uptime", bench_values[0]);
+    json_writer_add_uint64(&json, "idle", bench_values[1]);
+    json_writer_add_uint64(&json, "sleep", bench_values[2]);
+    json_writer_add_uint64(&json, "deepsleep", bench_values[3]);
+    json_writer_add_uint64(&json, "nw_suspend_deepsleep", bench_values[4]);
+    json_writer_end_object(&json);
+
+    return json.length;
+}
+
+static uint32_t bench_snprintf(char *buf)
+{
+    return (uint32_t)snprintf(buf, BENCH_BUF_LEN,
+                              "{\"uptime\":%llu,\"idle\":%llu,\"sleep\":%llu,"
+                              "\"deepsleep\":%llu,\"nw_suspend_deepsleep\":%llu}",
+                              (unsigned long long)bench_values[0],
+                              (unsigned long long)bench_values[1],
+                              (unsigned long long)bench_values[2],
+                              (unsigned long long)bench_values[3],
+                              (unsigned long long)bench_values[4]);
+}
+
+static double bench_run(uint32_t (*format)(char *), char *buf)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        bench_sink = bench_sink + format(buf);
+    }
+
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now() - start).count() / BENCH_ITERATIONS;
+}
+
+int main(void)
+{
+    char json_buf[BENCH_BUF_LEN];
+    char printf_buf[BENCH_BUF_LEN];
+    double json_ns;
+    double printf_ns;
+
+    /* Both paths must produce the same document. */
+    bench_json_writer(json_buf);
+    bench_snprintf(printf_buf);
+    if (0 != strcmp(json_buf, printf_buf))
+    {
+        printf("bench_json_writer: outputs differ\n%s\n%s\n", json_buf, printf_buf);
+        return 1;
+    }
+
+    json_ns = bench_run(bench_json_writer, json_buf);
+    printf_ns = bench_run(bench_snprintf, printf_buf);
+
+    printf("bench_json_writer: json_writer %.1f ns, snprintf %.1f ns per document (%.2fx)\n",
+           json_ns, printf_ns, printf_ns / json_ns);
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
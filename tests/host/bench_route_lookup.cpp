@@ -0,0 +1,172 @@
+/******************************************************************************
+ * File Name: bench_route_lookup.cpp
+ *
+ * Description:
+ *   This file contains the benchmark of the URL dispatch. The HTTP server
+ *   library finds the resource of a request by comparing its URL with every
+ *   registered resource in registration order. The benchmark times that
+ *   linear search against a binary search over a table sorted at build
+ *   time, with 4, 32 and 128 routes.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "http_webserver_config.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define BENCH_LOOKUPS   (2000000)
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Keeps the result alive so the lookups are not optimized out. */
+static volatile uintptr_t bench_sink;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* As the library does: the first registered URL that matches. */
+static const char *bench_linear(const std::vector<const char *> &routes, const char *url)
+{
+    for (const char *route : routes)
+    {
+        if (0 == strcmp(route, url))
+        {
+            return route;
+        }
+    }
+    return NULL;
+}
+
+static const char *bench_sorted(const std::vector<const char *> &routes, const char *url)
+{
+    std::vector<const char *>::const_iterator it =
+        std::lower_bound(routes.begin(), routes.end(), url,
+                         [](const char *a, const char *b) { return strcmp(a, b) < 0; });
+
+    return ((routes.end() != it) && (0 == strcmp(*it, url))) ? *it : NULL;
+}
+
+static double bench_run(const char *(*lookup)(const std::vector<const char *> &, const char *),
+                        const std::vector<const char *> &routes,
+                        const std::vector<const char *> &requests)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        bench_sink = bench_sink + (uintptr_t)lookup(routes, requests[i % requests.size()]);
+    }
+
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now() - start).count() / BENCH_LOOKUPS;
+}
+
+int main(void)
+{
+    static const uint32_t counts[] = { 0, 32, 128 };
+    const app_http_route_t *app_routes;
+    uint32_t app_route_count;
+    std::vector<std::string> names;
+    std::mt19937 rng(1);
+
+    app_routes = app_http_server_routes(&app_route_count);
+
+    for (uint32_t count : counts)
+    {
+        std::vector<const char *> routes;
+        std::vector<const char *> sorted;
+        std::vector<const char *> requests;
+
+        /* The routes of the application, then made-up pages of the same
+         * shape up to the route count. A count of 0 is the application
+         * alone.
+         */
+        count = std::max(count, app_route_count);
+        names.clear();
+        names.reserve(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            char name[16];
+
+            if (i < app_route_count)
+            {
+                names.push_back(app_routes[i].url);
+            }
+            else
+            {
+                snprintf(name, sizeof(name), "/page%03u", (unsigned int)i);
+                names.push_back(name);
+            }
+        }
+        for (const std::string &name : names)
+        {
+            routes.push_back(name.c_str());
+        }
+        sorted = routes;
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const char *a, const char *b) { return strcmp(a, b) < 0; });
+
+        /* Every route requested equally often, in random order. */
+        for (uint32_t i = 0; i < 1024; i++)
+        {
+            requests.push_back(routes[rng() % routes.size()]);
+        }
+        for (const char *request : requests)
+        {
+            if (bench_linear(routes, request) != bench_sorted(sorted, request))
+            {
+                printf("bench_route_lookup: lookups differ for %s\n", request);
+                return 1;
+            }
+        }
+
+        printf("bench_route_lookup: %3u routes: linear %.1f ns, sorted %.1f ns per lookup\n",
+               count, bench_run(bench_linear, routes, requests),
+               bench_run(bench_sorted, sorted, requests));
+    }
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,208 @@
+/******************************************************************************
+ * File Name: bench_writev.cpp
+ *
+ * Description:
+ *   This file contains the benchmark of the template page writes. It sends
+ *   the /sleep and /wake pages by copying the head, the IP address, and the
+ *   tail into a response buffer and writing the buffer, as the handlers did
+ *   before, and by writing the three fragments in place, as they do now. It
+ *   reports the bytes copied, the stream writes, and the time per page.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "host_platform.h"
+#include "http_webserver_config.h"
+#include "http_response_writer.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define BENCH_ITERATIONS   (1000000)
+
+/* Bytes the HTTP server adds around each write of a dynamic page, which is
+ * sent with chunked transfer encoding: up to three hex digits of chunk size
+ * and two CRLFs for a write of up to HTTP_BYTES_LEN bytes.
+ */
+#define BENCH_CHUNK_FRAMING (3 + 2 + 2)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+typedef struct
+{
+    std::string head;
+    std::string slot;
+    std::string tail;
+} bench_page_t;
+
+typedef struct
+{
+    uint32_t bytes_copied;
+    uint32_t writes;
+    double   ns;
+} bench_result_t;
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+extern HTTPServer *server;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Splits a page served by the application around its IP address slot. */
+static bool bench_page_load(const char *url, bench_page_t *page)
+{
+    cy_http_response_stream_t stream;
+    SocketAddress address;
+    size_t slot;
+
+    host_http_request(url, &stream, NULL);
+    page->slot = address.get_ip_address();
+    slot = stream.body.find(page->slot);
+    if (std::string::npos == slot)
+    {
+        return false;
+    }
+    page->head = stream.body.substr(0, slot);
+    page->tail = stream.body.substr(slot + page->slot.size());
+    return true;
+}
+
+static uint32_t bench_copy_write(const bench_page_t *page, cy_http_response_stream_t *stream,
+                                 char *buf)
+{
+    uint32_t length = 0;
+
+    memcpy(buf + length, page->head.data(), page->head.size());
+    length += page->head.size();
+    memcpy(buf + length, page->slot.data(), page->slot.size());
+    length += page->slot.size();
+    memcpy(buf + length, page->tail.data(), page->tail.size());
+    length += page->tail.size();
+    server->http_response_stream_write(stream, buf, length);
+
+    return length;
+}
+
+static uint32_t bench_gather_write(const bench_page_t *page, cy_http_response_stream_t *stream,
+                                   char *buf)
+{
+    const http_iovec_t iov[] = {
+        { page->head.data(), (uint32_t)page->head.size() },
+        { page->slot.data(), (uint32_t)page->slot.size() },
+        { page->tail.data(), (uint32_t)page->tail.size() }
+    };
+
+    (void)buf;
+    http_response_stream_writev(server, stream, iov, sizeof(iov) / sizeof(iov[0]));
+
+    return 0;
+}
+
+static bench_result_t bench_run(uint32_t (*write)(const bench_page_t *, cy_http_response_stream_t *,
+                                                  char *),
+                                const bench_page_t *page, std::string *body)
+{
+    char buf[HTTP_BYTES_LEN];
+    cy_http_response_stream_t stream;
+    bench_result_t result;
+    std::chrono::steady_clock::time_point start;
+
+    /* One page to check the output and count the writes. */
+    result.bytes_copied = write(page, &stream, buf);
+    result.writes = stream.writes;
+    *body = stream.body;
+
+    stream.body.reserve(HTTP_BYTES_LEN);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        stream.body.clear();
+        write(page, &stream, buf);
+    }
+    result.ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start).count() / BENCH_ITERATIONS;
+
+    return result;
+}
+
+int main(void)
+{
+    static const char *const urls[] = { "/sleep", "/wake" };
+    int status = 0;
+
+    host_http_init();
+
+    for (const char *url : urls)
+    {
+        bench_page_t page;
+        bench_result_t copy;
+        bench_result_t gather;
+        std::string copy_body;
+        std::string gather_body;
+
+        if (!bench_page_load(url, &page) ||
+            ((page.head.size() + page.slot.size() + page.tail.size()) > HTTP_BYTES_LEN))
+        {
+            printf("bench_writev: cannot split %s around its slot\n", url);
+            return 1;
+        }
+
+        copy   = bench_run(bench_copy_write, &page, &copy_body);
+        gather = bench_run(bench_gather_write, &page, &gather_body);
+
+        /* Both paths must send the same page. */
+        if (copy_body != gather_body)
+        {
+            printf("bench_writev: %s outputs differ\n", url);
+            status = 1;
+        }
+
+        printf("bench_writev: %-6s %zu bytes: copy-then-write %u bytes copied, %u write(s), "
+               "%u framing bytes, %.1f ns; gather-write %u bytes copied, %u write(s), "
+               "%u framing bytes, %.1f ns per page\n",
+               url, copy_body.size(),
+               copy.bytes_copied, copy.writes, copy.writes * BENCH_CHUNK_FRAMING, copy.ns,
+               gather.bytes_copied, gather.writes, gather.writes * BENCH_CHUNK_FRAMING, gather.ns);
+    }
+
+    return status;
+}
+
+
+/* [] END OF FILE */
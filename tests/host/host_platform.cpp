@@ -0,0 +1,344 @@
+/******************************************************************************
+ * File Name: host_platform.cpp
+ *
+ * Description:
+ *   This file contains the host platform used by the host tests. It implements
+ *   the stubbed Mbed OS, Wi-Fi and HTTP server APIs on top of a virtual clock
+ *   and in-memory response streams.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include "host_platform.h"
+#include "http_webserver_config.h"
+#include "network_activity_handler.h"
+#include "wake_reason.h"
+#include "lwip/netif.h"
+#include "lwip/priv/tcp_priv.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define HOST_IP_ADDRESS   "192.168.0.5"
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+typedef struct
+{
+    std::string           mime_type;
+    cy_url_resource_type  type;
+    void                 *resource;
+} host_route_t;
+
+static volatile uint64_t host_now_ms;
+static us_timestamp_t host_cpu_stats[4];
+static std::map<std::string, host_route_t> host_routes;
+static volatile uint32_t host_disconnect_all_calls;
+static volatile bool host_keep_connections;
+
+/* Defined by http_webserver_config.cpp. */
+extern HTTPServer *server;
+
+/* Defined by main.cpp on the target. */
+WhdSTAInterface *wifi;
+static WhdSTAInterface host_wifi;
+
+us_timestamp_t cy_dsleep_nw_suspend_time;
+
+/* Interface of the Wi-Fi station. The stack only counts the frames. */
+static volatile uint32_t host_nw_received;
+static err_t host_netif_input(struct pbuf *p, struct netif *inp);
+static err_t host_netif_linkoutput(struct netif *netif, struct pbuf *p);
+static struct netif host_netif = { host_netif_input, host_netif_linkoutput };
+struct netif *netif_default = &host_netif;
+
+/* HTTP connection, in tcp_active_pcbs while a response is unacknowledged. */
+static struct tcp_pcb host_http_pcb;
+static uint8_t host_http_segment;
+struct tcp_pcb *tcp_active_pcbs;
+
+static void (*host_thread_sleep_hook)(uint64_t until_ms);
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+void host_clock_set_ms(uint64_t now_ms)
+{
+    core_util_atomic_store_u64(&host_now_ms, now_ms);
+}
+
+void host_clock_advance_ms(uint64_t delta_ms)
+{
+    core_util_atomic_incr_u64(&host_now_ms, delta_ms);
+}
+
+uint64_t host_clock_now_ms(void)
+{
+    return core_util_atomic_load_u64(&host_now_ms);
+}
+
+Kernel::Clock::time_point Kernel::Clock::now()
+{
+    return time_point(duration(host_clock_now_ms()));
+}
+
+void ThisThread::sleep_for(Kernel::Clock::duration_u32 rel_time)
+{
+    uint64_t until_ms = host_clock_now_ms() + rel_time.count();
+
+    if (NULL != host_thread_sleep_hook)
+    {
+        host_thread_sleep_hook(until_ms);
+    }
+    host_clock_set_ms(until_ms);
+}
+
+void host_set_thread_sleep_hook(void (*hook)(uint64_t until_ms))
+{
+    host_thread_sleep_hook = hook;
+}
+
+void host_set_cpu_stats(us_timestamp_t uptime, us_timestamp_t idle,
+                        us_timestamp_t sleep, us_timestamp_t deepsleep)
+{
+    host_cpu_stats[0] = uptime;
+    host_cpu_stats[1] = idle;
+    host_cpu_stats[2] = sleep;
+    host_cpu_stats[3] = deepsleep;
+}
+
+us_timestamp_t mbed_uptime(void)         { return host_cpu_stats[0]; }
+us_timestamp_t mbed_time_idle(void)      { return host_cpu_stats[1]; }
+us_timestamp_t mbed_time_sleep(void)     { return host_cpu_stats[2]; }
+us_timestamp_t mbed_time_deepsleep(void) { return host_cpu_stats[3]; }
+
+const char *SocketAddress::get_ip_address() const
+{
+    return HOST_IP_ADDRESS;
+}
+
+int WhdSTAInterface::get_ip_address(SocketAddress *address)
+{
+    (void)address;
+    return 0;
+}
+
+HTTPServer::HTTPServer(cy_network_interface_t *network_interface, uint16_t port,
+                       uint16_t max_sockets)
+{
+    (void)network_interface;
+    (void)port;
+    (void)max_sockets;
+}
+
+cy_rslt_t HTTPServer::register_resource(uint8_t *url, uint8_t *mime_type,
+                                        cy_url_resource_type url_resource_type,
+                                        void *resource_data)
+{
+    host_routes[(const char *)url] = { (const char *)mime_type, url_resource_type, resource_data };
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t HTTPServer::start()
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t HTTPServer::http_response_stream_write(cy_http_response_stream_t *stream,
+                                                 const void *data, uint32_t length)
+{
+    stream->writes++;
+    if (0 != stream->write_delay_us)
+    {
+        usleep(stream->write_delay_us);
+    }
+    if ((0 != stream->fail_at_write) && (stream->writes >= stream->fail_at_write))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (length > stream->max_write)
+    {
+        stream->max_write = length;
+    }
+    if (stream->chunked && (0 != length))
+    {
+        /* "<size in hex>\r\n" before the data and "\r\n" after it. */
+        stream->framing += (uint32_t)snprintf(NULL, 0, "%x", (unsigned int)length) + 4;
+    }
+    stream->body.append((const char *)data, length);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t HTTPServer::http_response_stream_flush(cy_http_response_stream_t *stream)
+{
+    stream->flushes++;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t HTTPServer::http_response_stream_disconnect_all()
+{
+    if (!core_util_atomic_load_bool(&host_keep_connections))
+    {
+        core_util_atomic_incr_u32(&host_disconnect_all_calls, 1);
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+void host_http_keep_connections(bool keep)
+{
+    core_util_atomic_store_bool(&host_keep_connections, keep);
+}
+
+uint32_t host_http_disconnect_all_count(void)
+{
+    return core_util_atomic_load_u32(&host_disconnect_all_calls);
+}
+
+void host_http_init(void)
+{
+    wifi = &host_wifi;
+    wake_reason_init();
+    app_http_server_init(wifi);
+}
+
+static err_t host_netif_input(struct pbuf *p, struct netif *inp)
+{
+    (void)p;
+    (void)inp;
+    core_util_atomic_incr_u32(&host_nw_received, 1);
+    return ERR_OK;
+}
+
+static err_t host_netif_linkoutput(struct netif *netif, struct pbuf *p)
+{
+    (void)netif;
+    (void)p;
+    return ERR_OK;
+}
+
+uint16_t pbuf_copy_partial(const struct pbuf *buf, void *dataptr, uint16_t len, uint16_t offset)
+{
+    uint16_t copied = 0;
+
+    for (const struct pbuf *q = buf; (NULL != q) && (copied < len); q = q->next)
+    {
+        if (offset >= q->len)
+        {
+            offset -= q->len;
+            continue;
+        }
+        uint16_t n = std::min<uint16_t>(q->len - offset, len - copied);
+        memcpy((uint8_t *)dataptr + copied, (const uint8_t *)q->payload + offset, n);
+        copied += n;
+        offset = 0;
+    }
+    return copied;
+}
+
+void host_nw_receive(const uint8_t *frame, uint16_t length)
+{
+    struct pbuf p = { NULL, const_cast<uint8_t *>(frame), length, length };
+
+    netif_default->input(&p, netif_default);
+}
+
+uint32_t host_nw_received_count(void)
+{
+    return core_util_atomic_load_u32(&host_nw_received);
+}
+
+void host_http_sent(void)
+{
+    host_http_pcb.local_port   = HTTP_PORT;
+    host_http_pcb.unacked      = (struct tcp_seg *)&host_http_segment;
+    host_http_pcb.snd_queuelen = 1;
+    tcp_active_pcbs = &host_http_pcb;
+}
+
+void host_http_acked(void)
+{
+    host_http_pcb.unacked      = NULL;
+    host_http_pcb.snd_queuelen = 0;
+}
+
+const char *host_http_mime_type(const char *url)
+{
+    std::map<std::string, host_route_t>::const_iterator route = host_routes.find(url);
+
+    return (host_routes.end() == route) ? NULL : route->second.mime_type.c_str();
+}
+
+int32_t host_http_request(const char *url, cy_http_response_stream_t *stream,
+                          cy_http_message_body_t *body)
+{
+    std::map<std::string, host_route_t>::const_iterator route = host_routes.find(url);
+    const cy_resource_static_data_t *static_data;
+    const cy_resource_dynamic_data_t *dynamic_data;
+    int32_t result;
+
+    if (host_routes.end() == route)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    switch (route->second.type)
+    {
+        case CY_STATIC_URL_CONTENT:
+        case CY_RAW_STATIC_URL_CONTENT:
+            static_data = (const cy_resource_static_data_t *)route->second.resource;
+            return server->http_response_stream_write(stream, static_data->data,
+                                                      static_data->length);
+
+        case CY_DYNAMIC_URL_CONTENT:
+        case CY_RAW_DYNAMIC_URL_CONTENT:
+        default:
+            dynamic_data = (const cy_resource_dynamic_data_t *)route->second.resource;
+            stream->chunked = (CY_DYNAMIC_URL_CONTENT == route->second.type);
+            result = dynamic_data->resource_handler(url, "", stream, dynamic_data->arg, body);
+            if (stream->chunked)
+            {
+                /* The last chunk: "0\r\n\r\n". */
+                stream->framing += 5;
+            }
+            return result;
+    }
+}
+
+
+/* [] END OF FILE */
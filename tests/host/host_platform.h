@@ -0,0 +1,129 @@
+/******************************************************************************
+ * File Name: host_platform.h
+ *
+ * Description:
+ *   This file contains the declarations of the host platform used by the host
+ *   tests: the virtual clock, the CPU statistics reported by the stubbed
+ *   Mbed OS, and the in-memory HTTP response streams.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_PLATFORM_H
+#define HOST_PLATFORM_H
+
+#include <string>
+#include "mbed.h"
+#include "HTTP_server.hpp"
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Response stream captured in memory. A write fails once 'fail_at_write'
+ * writes have been made, if it is not 0. 'max_write' is the longest single
+ * write, which is one chunk on the kit. Each write takes 'write_delay_us' of
+ * real time, as a write blocks on a slow client on the kit. The library
+ * sends the response of a CY_DYNAMIC_URL_CONTENT resource with chunked
+ * transfer encoding, one chunk per write; 'framing' counts the chunk size
+ * lines, the CRLF after each chunk and the last chunk that this adds to
+ * 'body' on the wire.
+ */
+struct cy_http_response_stream
+{
+    std::string body;
+    uint32_t    writes         = 0;
+    uint32_t    max_write      = 0;
+    uint32_t    flushes        = 0;
+    uint32_t    fail_at_write  = 0;
+    uint32_t    write_delay_us = 0;
+    bool        chunked        = false;
+    uint32_t    framing        = 0;
+};
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+/* Virtual clock read by Kernel::Clock::now(), in milliseconds. */
+void host_clock_set_ms(uint64_t now_ms);
+void host_clock_advance_ms(uint64_t delta_ms);
+uint64_t host_clock_now_ms(void);
+
+/* Values returned by mbed_uptime() and the mbed_time_*() functions. */
+void host_set_cpu_stats(us_timestamp_t uptime, us_timestamp_t idle,
+                        us_timestamp_t sleep, us_timestamp_t deepsleep);
+
+/* Starts the HTTP server of the application with the host Wi-Fi interface,
+ * and wraps the interface for the wake reasons, as main.cpp does.
+ */
+void host_http_init(void);
+
+/* Serves a request for 'url' through the registered resource, as the HTTP
+ * server library would. Returns the handler result, or CY_RSLT_TYPE_ERROR if
+ * no resource is registered for the URL.
+ */
+int32_t host_http_request(const char *url, cy_http_response_stream_t *stream,
+                          cy_http_message_body_t *body);
+
+/* MIME type 'url' was registered with, or NULL if it is not registered. */
+const char *host_http_mime_type(const char *url);
+
+/* Number of http_response_stream_disconnect_all() calls that closed the
+ * connections. With 'keep' set, the calls leave the connections open and
+ * are not counted, as if http-evict-before-suspend were false.
+ */
+uint32_t host_http_disconnect_all_count(void);
+void host_http_keep_connections(bool keep);
+
+/* Passes a received Ethernet frame to the input function of the default
+ * interface, as the WLAN driver does.
+ */
+void host_nw_receive(const uint8_t *frame, uint16_t length);
+
+/* Number of frames the default interface received. */
+uint32_t host_nw_received_count(void);
+
+/* Function called by ThisThread::sleep_for() before the virtual clock moves
+ * on to 'until_ms', so that a simulation can pass the packets that arrive
+ * meanwhile to the stack. NULL, the default, calls nothing.
+ */
+void host_set_thread_sleep_hook(void (*hook)(uint64_t until_ms));
+
+/* Puts a response on the HTTP connection of the host, which stays in
+ * tcp_active_pcbs unacknowledged until host_http_acked() is called.
+ */
+void host_http_sent(void);
+void host_http_acked(void);
+
+#endif /* #ifndef HOST_PLATFORM_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,542 @@
+/******************************************************************************
+ * File Name: host_sleep_sim.cpp
+ *
+ * Description:
+ *   This file contains the host sleep simulator. Its wait_net_suspend() takes
+ *   the place of the LPA network activity handler: it reads the packet arrivals
+ *   from a trace instead of the emac activity callback, and moves the virtual
+ *   clock instead of waiting on a semaphore and a thread. Like the handler, it
+ *   watches the network for one interval at a time and suspends the stack at
+ *   the end of the first interval whose last window_ms had no packet. The stack
+ *   stays suspended, in deep sleep, until the next packet that the WLAN device
+ *   does not answer itself. The suspend cycle of the application runs
+ *   unchanged on top of it.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include "host_platform.h"
+#include "host_sleep_sim.h"
+#include "network_activity_handler.h"
+#include "app_stats.h"
+#include "host_sleep.h"
+#include "nw_suspend.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define SIM_ARP_PERIOD_MS      (60000)
+#define SIM_PAGE_PERIOD_MS     (600000)
+#define SIM_CHATTY_PERIOD_MS   (15000)
+#define SIM_CHATTY_BURST       (5)
+#define SIM_CHATTY_GAP_MS      (100)
+#define SIM_BUSY_PERIOD_MS     (20)
+#define SIM_SLEEP_PERIOD_MS    (300000)
+#define SIM_SLEEP_OFFSET_MS    (5000)
+#define SIM_ACK_DELAY_MS       (40)
+#define SIM_LATE_ACK_DELAY_MS  (3000)
+#define SIM_KEEPALIVE_PERIOD_MS (10000)
+
+#define SIM_FRAME_LEN          (64)
+#define SIM_ETH_HEADER_LEN     (14)
+#define SIM_IPV4_HEADER_LEN    (20)
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Trace being run, and where wait_net_suspend() is in it. Only the packets
+ * that arrive before end_ms are part of the run.
+ */
+typedef struct
+{
+    const host_nw_packet_t *packets;
+    size_t                  count;
+    size_t                  next;
+    uint64_t                start_ms;
+    uint64_t                end_ms;
+    bool                    arp_offload;
+    const host_nw_packet_t *resumed_by;
+    uint32_t                timeouts;
+    uint32_t                arp_offloaded;
+    bool                    connection_open;
+    uint32_t                connection_closes;
+    uint32_t                keepalives_dropped;
+} host_sim_trace_t;
+
+static host_sim_trace_t host_sim;
+
+static const char* const host_sim_packet_names[HOST_NW_PACKET_MAX] = {
+    "arp",
+    "http",
+    "sleep",
+    "ack",
+    "keepalive",
+    "broadcast",
+    "ping",
+    "udp",
+    "other"
+};
+
+/* Defined by host_platform.cpp, as by main.cpp on the target. */
+extern WhdSTAInterface *wifi;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static uint64_t host_sim_packet_ms(size_t index)
+{
+    return host_sim.start_ms + host_sim.packets[index].time_ms;
+}
+
+/* Builds the Ethernet frame of a packet kind, sent to the device by the
+ * access point: an ARP request, a TCP segment to port 80 for HTTP and sleep
+ * requests, ACKs and keep-alive segments, an mDNS query, an ICMP echo request, a UDP datagram to port
+ * 5004, or an EAPOL key frame.
+ */
+static uint16_t host_sim_frame(host_nw_packet_kind_t kind, uint8_t *frame)
+{
+    static const uint8_t device_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x05 };
+    static const uint8_t broadcast_mac[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    static const uint8_t mdns_mac[6] = { 0x01, 0x00, 0x5E, 0x00, 0x00, 0xFB };
+    uint8_t *ip = &frame[SIM_ETH_HEADER_LEN];
+    uint8_t *l4 = &ip[SIM_IPV4_HEADER_LEN];
+    uint16_t ether_type = 0x0800;
+    uint16_t port = 0;
+
+    memset(frame, 0, SIM_FRAME_LEN);
+    memcpy(frame, device_mac, sizeof(device_mac));
+    frame[6] = 0x02;
+    frame[11] = 0x01;
+    ip[0] = 0x45;
+    switch (kind)
+    {
+        case HOST_NW_PACKET_ARP:
+            memcpy(frame, broadcast_mac, sizeof(broadcast_mac));
+            ether_type = 0x0806;
+            break;
+        case HOST_NW_PACKET_HTTP:
+        case HOST_NW_PACKET_SLEEP:
+        case HOST_NW_PACKET_ACK:
+        case HOST_NW_PACKET_KEEPALIVE:
+            ip[9] = 6;
+            port = 80;
+            break;
+        case HOST_NW_PACKET_BROADCAST:
+            memcpy(frame, mdns_mac, sizeof(mdns_mac));
+            ip[9] = 17;
+            port = 5353;
+            break;
+        case HOST_NW_PACKET_PING:
+            ip[9] = 1;
+            l4[0] = 8;
+            break;
+        case HOST_NW_PACKET_UDP:
+            ip[9] = 17;
+            port = 5004;
+            break;
+        default:
+            ether_type = 0x888E;
+            break;
+    }
+    frame[12] = (uint8_t)(ether_type >> 8);
+    frame[13] = (uint8_t)ether_type;
+    l4[2] = (uint8_t)(port >> 8);
+    l4[3] = (uint8_t)port;
+
+    return SIM_FRAME_LEN;
+}
+
+/* Passes packet 'index' to the stack at its arrival time, and serves the
+ * page of an HTTP or sleep request as the HTTP server thread would. The
+ * response stays on the HTTP connection until the client ACKs it.
+ */
+static void host_sim_receive(size_t index)
+{
+    cy_http_response_stream_t stream;
+    uint8_t frame[SIM_FRAME_LEN];
+    uint16_t length = host_sim_frame(host_sim.packets[index].kind, frame);
+
+    host_clock_set_ms(host_sim_packet_ms(index));
+    host_nw_receive(frame, length);
+    if ((HOST_NW_PACKET_HTTP == host_sim.packets[index].kind) ||
+        (HOST_NW_PACKET_SLEEP == host_sim.packets[index].kind))
+    {
+        host_sim.connection_open   = true;
+        host_sim.connection_closes = host_http_disconnect_all_count();
+    }
+
+    if (HOST_NW_PACKET_HTTP == host_sim.packets[index].kind)
+    {
+        host_http_sent();
+        host_http_request("/", &stream, NULL);
+    }
+    else if (HOST_NW_PACKET_SLEEP == host_sim.packets[index].kind)
+    {
+        host_http_sent();
+        host_http_request("/sleep", &stream, NULL);
+    }
+    else if (HOST_NW_PACKET_ACK == host_sim.packets[index].kind)
+    {
+        host_http_acked();
+    }
+}
+
+/* Skips the keep-alive segments of a connection that the HTTP server has
+ * closed since the last request: the client stops sending them. Returns
+ * true if a packet is left in the trace.
+ */
+static bool host_sim_has_next(void)
+{
+    while ((host_sim.next < host_sim.count) &&
+           (HOST_NW_PACKET_KEEPALIVE == host_sim.packets[host_sim.next].kind) &&
+           (!host_sim.connection_open ||
+            (host_http_disconnect_all_count() != host_sim.connection_closes)))
+    {
+        host_sim.connection_open = false;
+        host_sim.keepalives_dropped++;
+        host_sim.next++;
+    }
+
+    return (host_sim.next < host_sim.count);
+}
+
+/* Passes the packets that arrive while the sleep thread sleeps, such as
+ * the ACK it waits for before the stack is suspended.
+ */
+static void host_sim_thread_sleep(uint64_t until_ms)
+{
+    while (host_sim_has_next() && (host_sim_packet_ms(host_sim.next) < until_ms))
+    {
+        if (host_sim_packet_ms(host_sim.next) >= host_clock_now_ms())
+        {
+            host_sim_receive(host_sim.next);
+        }
+        host_sim.next++;
+    }
+}
+
+/* As the LPA: watches the network for one interval, starting with the call.
+ * The window restarts at each packet the stack handles. If a whole window
+ * passes without a packet before the interval ends, the stack is suspended
+ * at the end of that window; otherwise the call returns at the end of the
+ * interval with ST_WAIT_INACTIVITY_TIMEOUT_EXPIRED. The packets in the
+ * interval are passed to the stack. While suspended, ARP requests are
+ * answered by the WLAN device if ARP offload is enabled; the stack resumes
+ * at the next other packet, which is passed to the stack, after wait_ms, or
+ * at the end of the run, whichever comes first.
+ */
+int32_t wait_net_suspend(void *net_intf, uint32_t wait_ms,
+                         uint32_t network_inactive_interval_ms,
+                         uint32_t network_inactive_window_ms)
+{
+    uint64_t now_ms = host_clock_now_ms();
+    uint64_t interval_end_ms = now_ms + network_inactive_interval_ms;
+    uint64_t last_activity_ms = now_ms;
+    uint64_t suspend_ms;
+    uint64_t wait_end_ms;
+    uint64_t resume_ms;
+    int32_t result = ST_SUCCESS;
+
+    host_sim.resumed_by = NULL;
+    if ((NULL == host_sim.packets) || (0 == network_inactive_window_ms) ||
+        (network_inactive_window_ms > network_inactive_interval_ms))
+    {
+        return ST_BAD_ARGS;
+    }
+
+    /* Packets that arrived while the stack was up have been handled. */
+    while (host_sim_has_next() && (host_sim_packet_ms(host_sim.next) < now_ms))
+    {
+        host_sim.next++;
+    }
+
+    /* Packets inside the window keep the stack up and restart the window. */
+    while (host_sim_has_next() &&
+           (host_sim_packet_ms(host_sim.next) < (last_activity_ms + network_inactive_window_ms)) &&
+           ((last_activity_ms + network_inactive_window_ms) <= interval_end_ms))
+    {
+        last_activity_ms = host_sim_packet_ms(host_sim.next);
+        host_sim_receive(host_sim.next);
+        host_sim.next++;
+    }
+    suspend_ms = last_activity_ms + network_inactive_window_ms;
+    if (suspend_ms > interval_end_ms)
+    {
+        while (host_sim_has_next() &&
+               (host_sim_packet_ms(host_sim.next) < interval_end_ms))
+        {
+            host_sim_receive(host_sim.next);
+            host_sim.next++;
+        }
+        host_clock_set_ms(interval_end_ms);
+        host_sim.timeouts++;
+        return ST_WAIT_INACTIVITY_TIMEOUT_EXPIRED;
+    }
+
+    wait_end_ms = (osWaitForever == wait_ms) ? UINT64_MAX : (suspend_ms + wait_ms);
+    while (host_sim_has_next() && host_sim.arp_offload &&
+           (HOST_NW_PACKET_ARP == host_sim.packets[host_sim.next].kind) &&
+           (host_sim_packet_ms(host_sim.next) < wait_end_ms))
+    {
+        host_sim.arp_offloaded++;
+        host_sim.next++;
+    }
+
+    if (host_sim_has_next() && (host_sim_packet_ms(host_sim.next) < wait_end_ms))
+    {
+        host_sim.resumed_by = &host_sim.packets[host_sim.next];
+        resume_ms = host_sim_packet_ms(host_sim.next);
+        host_sim_receive(host_sim.next);
+        host_sim.next++;
+    }
+    else if (wait_end_ms < host_sim.end_ms)
+    {
+        resume_ms = wait_end_ms;
+        result = ST_WAIT_TIMEOUT_EXPIRED;
+    }
+    else
+    {
+        resume_ms = std::max(suspend_ms, host_sim.end_ms);
+    }
+
+    cy_dsleep_nw_suspend_time += (resume_ms - suspend_ms) * 1000;
+    host_clock_set_ms(resume_ms);
+    return result;
+}
+
+bool host_sleep_sim_load(const char *path, std::vector<host_nw_packet_t> *trace)
+{
+    FILE *file = fopen(path, "r");
+    char line[128];
+    char kind[16] = "";
+    unsigned long long time_ms;
+    host_nw_packet_t packet;
+    bool ok = (NULL != file);
+
+    trace->clear();
+    while (ok && (NULL != fgets(line, sizeof(line), file)))
+    {
+        if (('#' == line[0]) || (strspn(line, " \t\r\n") == strlen(line)))
+        {
+            continue;
+        }
+
+        ok = (2 == sscanf(line, "%llu %15s", &time_ms, kind));
+        for (packet.kind = HOST_NW_PACKET_ARP; packet.kind < HOST_NW_PACKET_MAX;
+             packet.kind = (host_nw_packet_kind_t)(packet.kind + 1))
+        {
+            if (0 == strcmp(kind, host_sim_packet_names[packet.kind]))
+            {
+                break;
+            }
+        }
+        ok = ok && (packet.kind < HOST_NW_PACKET_MAX);
+        packet.time_ms = time_ms;
+        trace->push_back(packet);
+    }
+    if (NULL != file)
+    {
+        fclose(file);
+    }
+
+    std::stable_sort(trace->begin(), trace->end(),
+                     [](const host_nw_packet_t &a, const host_nw_packet_t &b)
+                     { return a.time_ms < b.time_ms; });
+    return ok;
+}
+
+bool host_sleep_sim_synthetic(const char *name, uint64_t duration_ms,
+                              std::vector<host_nw_packet_t> *trace)
+{
+    trace->clear();
+    if ((0 != strcmp(name, "quiet")) && (0 != strcmp(name, "web")) &&
+        (0 != strcmp(name, "lossy")) && (0 != strcmp(name, "keepalive")) &&
+        (0 != strcmp(name, "chatty")) && (0 != strcmp(name, "busy")))
+    {
+        return false;
+    }
+
+    /* A client puts the host to sleep 5 seconds after the start and every
+     * 5 minutes from then on; in 'web', the requests that follow a page
+     * load come 5 seconds after it. The host stays awake in between once a
+     * packet has woken it. The client ACKs each response 40 ms after the
+     * request. 'lossy' is 'web' with the first ACK of each response to a
+     * sleep request lost: the client only ACKs the retransmission, 3 seconds
+     * later, once the stack has been suspended.
+     */
+    for (uint64_t t = SIM_SLEEP_OFFSET_MS; t < duration_ms; t += SIM_SLEEP_PERIOD_MS)
+    {
+        trace->push_back({ t, HOST_NW_PACKET_SLEEP });
+        trace->push_back({ t + ((0 == strcmp(name, "lossy")) ? SIM_LATE_ACK_DELAY_MS
+                                                             : SIM_ACK_DELAY_MS),
+                           HOST_NW_PACKET_ACK });
+    }
+    if (0 == strcmp(name, "busy"))
+    {
+        /* A stream with no lull at all, such as a video. */
+        for (uint64_t t = 0; t < duration_ms; t += SIM_BUSY_PERIOD_MS)
+        {
+            trace->push_back({ t, HOST_NW_PACKET_UDP });
+        }
+    }
+
+    /* Every trace but 'busy' has the access point refresh its ARP entry for
+     * the device once a minute. 'web' adds a page load every 10 minutes, and
+     * 'chatty' a burst of broadcasts, such as mDNS, every 15 seconds. The
+     * sleep requests are added to every trace below.
+     */
+    for (uint64_t t = SIM_ARP_PERIOD_MS / 2;
+         (0 != strcmp(name, "busy")) && (t < duration_ms); t += SIM_ARP_PERIOD_MS)
+    {
+        trace->push_back({ t, HOST_NW_PACKET_ARP });
+    }
+    if ((0 == strcmp(name, "web")) || (0 == strcmp(name, "lossy")) ||
+        (0 == strcmp(name, "keepalive")))
+    {
+        for (uint64_t t = SIM_PAGE_PERIOD_MS; t < duration_ms; t += SIM_PAGE_PERIOD_MS)
+        {
+            trace->push_back({ t, HOST_NW_PACKET_HTTP });
+            trace->push_back({ t + SIM_ACK_DELAY_MS, HOST_NW_PACKET_ACK });
+        }
+    }
+
+    /* 'keepalive' is 'web' with a client that keeps its connection open
+     * after each request and sends on it every 10 seconds, as a slow client
+     * that sends its request headers a line at a time, or keep-alive
+     * probes. The client sends nothing once the HTTP server has closed the
+     * connection, until its next request.
+     */
+    for (uint64_t t = SIM_KEEPALIVE_PERIOD_MS;
+         (0 == strcmp(name, "keepalive")) && (t < duration_ms); t += SIM_KEEPALIVE_PERIOD_MS)
+    {
+        trace->push_back({ t, HOST_NW_PACKET_KEEPALIVE });
+    }
+    if (0 == strcmp(name, "chatty"))
+    {
+        for (uint64_t t = SIM_CHATTY_PERIOD_MS; t < duration_ms; t += SIM_CHATTY_PERIOD_MS)
+        {
+            for (uint32_t i = 0; i < SIM_CHATTY_BURST; i++)
+            {
+                trace->push_back({ t + (i * SIM_CHATTY_GAP_MS), HOST_NW_PACKET_BROADCAST });
+            }
+        }
+    }
+
+    std::stable_sort(trace->begin(), trace->end(),
+                     [](const host_nw_packet_t &a, const host_nw_packet_t &b)
+                     { return a.time_ms < b.time_ms; });
+    return true;
+}
+
+void host_sleep_sim_run(const std::vector<host_nw_packet_t> &trace, uint64_t duration_ms,
+                        bool arp_offload, host_sleep_sim_result_t *result)
+{
+    host_sleep_info_t sleep_info;
+    us_timestamp_t dsleep_start = cy_dsleep_nw_suspend_time;
+    us_timestamp_t uptime_us;
+    app_stats_t stats_start;
+    app_stats_t stats;
+
+    memset(result, 0, sizeof(*result));
+    memset(&host_sim, 0, sizeof(host_sim));
+    host_sim.packets     = trace.data();
+    host_sim.start_ms    = host_clock_now_ms();
+    host_sim.end_ms      = host_sim.start_ms + duration_ms;
+    host_sim.arp_offload = arp_offload;
+    while ((host_sim.count < trace.size()) && (trace[host_sim.count].time_ms < duration_ms))
+    {
+        result->sleep_requests += (HOST_NW_PACKET_SLEEP == trace[host_sim.count].kind) ? 1 : 0;
+        host_sim.count++;
+    }
+    app_stats_get(&stats_start);
+    host_set_thread_sleep_hook(host_sim_thread_sleep);
+
+    while (host_clock_now_ms() < host_sim.end_ms)
+    {
+        host_sleep_get_info(&sleep_info);
+        if (HOST_SLEEP_STATE_PENDING_SUSPEND == sleep_info.state)
+        {
+            nw_suspend_run(wifi);
+            if (NULL != host_sim.resumed_by)
+            {
+                result->wakes[host_sim.resumed_by->kind]++;
+            }
+        }
+        else if (host_sim_has_next())
+        {
+            /* Awake: the stack handles each packet as it arrives, until a
+             * sleep request.
+             */
+            if (host_sim_packet_ms(host_sim.next) >= host_clock_now_ms())
+            {
+                host_sim_receive(host_sim.next);
+            }
+            host_sim.next++;
+        }
+        else
+        {
+            host_clock_set_ms(host_sim.end_ms);
+        }
+    }
+
+    host_set_thread_sleep_hook(NULL);
+
+    /* The MCU is taken as in deep sleep while the stack is suspended, and
+     * in sleep otherwise, for the energy estimate.
+     */
+    uptime_us = host_clock_now_ms() * 1000;
+    host_set_cpu_stats(uptime_us, uptime_us,
+                       uptime_us - cy_dsleep_nw_suspend_time, cy_dsleep_nw_suspend_time);
+
+    app_stats_get(&stats);
+    result->duration_ms      = host_clock_now_ms() - host_sim.start_ms;
+    result->deep_sleep_ms    = (cy_dsleep_nw_suspend_time - dsleep_start) / 1000;
+    result->suspend_attempts = stats.nw_suspend_attempts - stats_start.nw_suspend_attempts;
+    result->suspends         = stats.nw_suspends - stats_start.nw_suspends;
+    result->timeouts         = host_sim.timeouts;
+    result->abandoned        = stats.nw_suspend_abandoned - stats_start.nw_suspend_abandoned;
+    result->drain_timeouts   = stats.http_drain_timeouts - stats_start.http_drain_timeouts;
+    result->arp_offloaded    = host_sim.arp_offloaded;
+    result->keepalives_dropped = host_sim.keepalives_dropped;
+    host_sim.packets = NULL;
+}
+
+const char* host_sleep_sim_packet_name(host_nw_packet_kind_t kind)
+{
+    return (kind < HOST_NW_PACKET_MAX) ? host_sim_packet_names[kind] : "unknown";
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * File Name: host_sleep_sim.h
+ *
+ * Description:
+ *   This file contains the declarations of the host sleep simulator: packet
+ *   traces, the trace-driven wait_net_suspend() of the host platform, and the
+ *   loop that runs the network stack suspend cycle of the application against a
+ *   trace on the virtual clock.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_SLEEP_SIM_H
+#define HOST_SLEEP_SIM_H
+
+#include <vector>
+#include "mbed.h"
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Kind of a packet that arrives at the device. ARP requests are answered by
+ * the WLAN device while the host network stack is suspended, if ARP offload
+ * is enabled. HTTP requests load the home page, and sleep requests the
+ * /sleep page, which asks the host to suspend the network stack. The
+ * response stays unacknowledged until the next ACK of the client. A
+ * keep-alive segment is sent by a client on the connection of its last
+ * request, only as long as the HTTP server keeps it open. Any other
+ * packet wakes the host and is dropped: a multicast mDNS query, a ping, a
+ * unicast UDP datagram of a stream, or an EAPOL key frame.
+ */
+typedef enum
+{
+    HOST_NW_PACKET_ARP,
+    HOST_NW_PACKET_HTTP,
+    HOST_NW_PACKET_SLEEP,
+    HOST_NW_PACKET_ACK,
+    HOST_NW_PACKET_KEEPALIVE,
+    HOST_NW_PACKET_BROADCAST,
+    HOST_NW_PACKET_PING,
+    HOST_NW_PACKET_UDP,
+    HOST_NW_PACKET_OTHER,
+    HOST_NW_PACKET_MAX
+} host_nw_packet_kind_t;
+
+/* Packet arrival, in milliseconds since the start of the trace. */
+typedef struct
+{
+    uint64_t              time_ms;
+    host_nw_packet_kind_t kind;
+} host_nw_packet_t;
+
+/* Outcome of a simulation run. */
+typedef struct
+{
+    uint64_t duration_ms;                /* Simulated time.                    */
+    uint64_t deep_sleep_ms;              /* Time the stack stayed suspended.   */
+    uint32_t suspend_attempts;           /* Calls to wait_net_suspend().       */
+    uint32_t suspends;                   /* Suspends followed by a resume.     */
+    uint32_t timeouts;                   /* Intervals that found no inactive window. */
+    uint32_t sleep_requests;             /* Requests to /sleep in the trace.   */
+    uint32_t abandoned;                  /* Sleep requests dropped without a suspend. */
+    uint32_t drain_timeouts;             /* Suspends with a response unacknowledged. */
+    uint32_t arp_offloaded;              /* ARP requests answered while suspended. */
+    uint32_t keepalives_dropped;         /* Keep-alives not sent, connection closed. */
+    uint32_t wakes[HOST_NW_PACKET_MAX];  /* Resumes, by kind of packet.        */
+} host_sleep_sim_result_t;
+
+/*********************************************************************
+ *                      FUNCTION DECLARATIONS
+ ********************************************************************/
+/* Reads a trace file: one packet per line, as the arrival time in
+ * milliseconds and the kind 'arp', 'http', 'sleep', 'ack', 'keepalive',
+ * 'broadcast', 'ping', 'udp' or 'other'. Empty lines and lines starting with '#' are skipped. Returns false if the file cannot be read or
+ * a line cannot be parsed.
+ */
+bool host_sleep_sim_load(const char *path, std::vector<host_nw_packet_t> *trace);
+
+/* Builds one of the synthetic traces 'quiet', 'web', 'lossy', 'keepalive',
+ * 'chatty' or 'busy' that lasts 'duration_ms'. Returns false if the name is unknown.
+ */
+bool host_sleep_sim_synthetic(const char *name, uint64_t duration_ms,
+                              std::vector<host_nw_packet_t> *trace);
+
+/* Runs the suspend cycle of the application against the trace for
+ * 'duration_ms', starting at the current time of the virtual clock. The host
+ * stays awake and handles each packet as it arrives until a sleep request
+ * in the trace; it then looks for an inactive window, and stays awake again
+ * once the stack resumes or the request is dropped. The packets the stack
+ * handles, including those that arrive while the sleep thread drains the
+ * response to the request, are passed to the default interface, and HTTP
+ * and sleep requests are served by the pages of the application. host_http_init() must have
+ * been called before.
+ */
+void host_sleep_sim_run(const std::vector<host_nw_packet_t> &trace, uint64_t duration_ms,
+                        bool arp_offload, host_sleep_sim_result_t *result);
+
+const char* host_sleep_sim_packet_name(host_nw_packet_kind_t kind);
+
+#endif /* #ifndef HOST_SLEEP_SIM_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,270 @@
+/******************************************************************************
+ * File Name: load_test.cpp
+ *
+ * Description:
+ *   This file contains the HTTP load test. It starts the HTTP server of the
+ *   application on the host platform and sends requests from several clients
+ *   at the same time, with a configurable mix of URLs and request bodies. The
+ *   handlers of the clients run at the same time, so they compete for the
+ *   response buffers. It reports the p50 and p99 service time per URL, which
+ *   is the time the handler takes in-process and leaves out the network and
+ *   the HTTP server library, the throughput, and the peak usage of the
+ *   response buffers.
+ *
+ *   Usage: load_test [-c clients] [-n requests per client] [-p body bytes]
+ *                    [-m url:weight,url:weight,...]
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_platform.h"
+#include "http_response_pool.h"
+#include "app_stats.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define LOAD_DEFAULT_CLIENTS    (4)
+#define LOAD_DEFAULT_REQUESTS   (2000)
+#define LOAD_DEFAULT_MIX        "/:4,/stats:2,/stats.json:2,/metrics:1,/sleep:1,/wake:1"
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+typedef struct
+{
+    std::string            url;
+    uint32_t               weight;
+    std::vector<double>    service_us;
+    uint32_t               exhausted;
+    uint32_t               errors;
+} load_url_t;
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+static std::vector<load_url_t> load_urls;
+
+/* Protects the service time samples. */
+static std::mutex load_results_mutex;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static bool load_parse_mix(const char *mix)
+{
+    std::string spec(mix);
+    size_t start = 0;
+
+    while (start < spec.size())
+    {
+        size_t end = spec.find(',', start);
+        std::string item = spec.substr(start, (std::string::npos == end) ? std::string::npos : (end - start));
+        size_t colon = item.rfind(':');
+        load_url_t url;
+
+        if ((std::string::npos == colon) || (0 == colon))
+        {
+            return false;
+        }
+        url.url    = item.substr(0, colon);
+        url.weight = (uint32_t)strtoul(item.c_str() + colon + 1, NULL, 10);
+        url.exhausted = 0;
+        url.errors    = 0;
+        if (0 == url.weight)
+        {
+            return false;
+        }
+        load_urls.push_back(url);
+
+        start = (std::string::npos == end) ? spec.size() : (end + 1);
+    }
+
+    return !load_urls.empty();
+}
+
+static void load_client(uint32_t id, uint32_t requests, uint32_t body_len)
+{
+    std::mt19937 rng(id + 1);
+    std::vector<uint32_t> choices;
+    std::vector<uint8_t> body_data(body_len, 'x');
+    cy_http_message_body_t body = { body_data.data(), (uint16_t)body_len, 0 };
+
+    for (uint32_t i = 0; i < load_urls.size(); i++)
+    {
+        choices.insert(choices.end(), load_urls[i].weight, i);
+    }
+
+    for (uint32_t n = 0; n < requests; n++)
+    {
+        load_url_t &url = load_urls[choices[rng() % choices.size()]];
+        cy_http_response_stream_t stream;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        cy_rslt_t result;
+        double service_us;
+
+        /* The clients are served at the same time, so the pages that take a
+         * response buffer compete for the pool.
+         */
+        result = (cy_rslt_t)host_http_request(url.url.c_str(), &stream, &body);
+        service_us = std::chrono::duration<double, std::micro>(
+                         std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(load_results_mutex);
+        url.service_us.push_back(service_us);
+        if ((CY_RSLT_TYPE_ERROR == result) && stream.body.empty())
+        {
+            /* No free response buffer: the request failed before sending. */
+            url.exhausted++;
+        }
+        else if ((CY_RSLT_SUCCESS != result) || stream.body.empty())
+        {
+            url.errors++;
+        }
+    }
+}
+
+static double load_percentile(std::vector<double> &samples, double percentile)
+{
+    size_t index;
+
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    index = (size_t)((percentile / 100.0) * (double)(samples.size() - 1) + 0.5);
+    return samples[index];
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t clients = LOAD_DEFAULT_CLIENTS;
+    uint32_t requests = LOAD_DEFAULT_REQUESTS;
+    uint32_t body_len = 0;
+    const char *mix = LOAD_DEFAULT_MIX;
+    std::vector<std::thread> threads;
+    std::chrono::steady_clock::time_point start;
+    double elapsed_s;
+    uint32_t errors = 0;
+    http_response_pool_stats_t pool_stats;
+    app_stats_t stats;
+    int saved_stdout;
+    int null_fd;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "c:n:p:m:")))
+    {
+        switch (opt)
+        {
+            case 'c': clients  = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'n': requests = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'p': body_len = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'm': mix      = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-c clients] [-n requests] [-p body bytes] "
+                                "[-m url:weight,...]\n", argv[0]);
+                return 2;
+        }
+    }
+    if ((0 == clients) || !load_parse_mix(mix) || (body_len > UINT16_MAX))
+    {
+        fprintf(stderr, "invalid arguments\n");
+        return 2;
+    }
+
+    host_set_cpu_stats(3600000000ULL, 3000000000ULL, 500000000ULL, 2400000000ULL);
+
+    /* The handlers log to the console; keep it out of the report. */
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+
+    host_http_init();
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < clients; i++)
+    {
+        threads.push_back(std::thread(load_client, i, requests, body_len));
+    }
+    for (std::thread &t : threads)
+    {
+        t.join();
+    }
+    elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+
+    printf("clients: %u, requests per client: %u, body: %u bytes\n", clients, requests, body_len);
+    printf("%-12s %8s %9s %8s %12s %12s %12s\n", "url", "requests", "exhausted", "errors",
+           "p50 svc(us)", "p99 svc(us)", "max svc(us)");
+    for (load_url_t &url : load_urls)
+    {
+        printf("%-12s %8zu %9u %8u %12.1f %12.1f %12.1f\n", url.url.c_str(), url.service_us.size(),
+               url.exhausted, url.errors, load_percentile(url.service_us, 50.0),
+               load_percentile(url.service_us, 99.0), load_percentile(url.service_us, 100.0));
+        errors += url.errors;
+    }
+    printf("throughput: %.0f requests/s\n", (double)(clients * requests) / elapsed_s);
+
+    http_response_pool_get_stats(&pool_stats);
+    app_stats_get(&stats);
+    printf("response buffers: peak %u of %u in use, peak %u of %u bytes, %u allocation failures\n",
+           pool_stats.peak_in_use, (unsigned int)HTTP_RESPONSE_POOL_SIZE, pool_stats.peak_bytes,
+           (unsigned int)HTTP_BYTES_LEN, pool_stats.alloc_failures);
+    printf("stream buffer chunks: peak %u of %u bytes\n",
+           pool_stats.peak_chunk_bytes, (unsigned int)HTTP_STREAM_CHUNK_LEN);
+    for (uint32_t i = 0; i < HTTP_RESPONSE_PAGE_MAX; i++)
+    {
+        printf("%-12s peak %u bytes\n", http_response_page_name((http_response_page_t)i),
+               pool_stats.page_peak_bytes[i]);
+    }
+    printf("dynamic page bytes sent: %llu\n", (unsigned long long)stats.http_bytes_sent);
+
+    return (0 == errors) ? 0 : 1;
+}
+
+
+/* [] END OF FILE */
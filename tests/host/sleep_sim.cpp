@@ -0,0 +1,193 @@
+/******************************************************************************
+ * File Name: sleep_sim.cpp
+ *
+ * Description:
+ *   This file contains the host sleep simulator. It runs the network stack
+ *   suspend cycle of the application, with the real sleep request, inactivity
+ *   window, wake reason, statistics and energy modules, against a packet trace
+ *   on the virtual clock. An hour of traffic runs in well under a second, so
+ *   changes to the NETWORK_INACTIVE_* values, the adaptive window and ARP
+ *   offload can be compared without a kit. It reports the deep sleep time, the
+ *   wakes, the suspend latency and the energy estimate.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <unistd.h>
+#include <stdlib.h>
+#include "host_platform.h"
+#include "host_sleep_sim.h"
+#include "app_stats.h"
+#include "energy_model.h"
+#include "nw_inactivity.h"
+#include "wake_reason.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define SIM_DEFAULT_TRACE       "web"
+#define SIM_DEFAULT_DURATION_S  (3600)
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void sim_print_histogram(app_stats_hist_t hist)
+{
+    log2_histogram_t snapshot;
+
+    app_stats_get_histogram(hist, &snapshot);
+    printf("%s (ms):\n", app_stats_histogram_name(hist));
+    for (uint32_t i = 0; i < LOG2_HISTOGRAM_BUCKETS; i++)
+    {
+        if (0 != snapshot.counts[i])
+        {
+            printf("  >= %10u: %u\n", log2_histogram_bucket_min(i), snapshot.counts[i]);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *trace_path = NULL;
+    const char *synthetic = SIM_DEFAULT_TRACE;
+    uint64_t duration_ms = 0;
+    bool arp_offload = true;
+    bool evict = true;
+    std::vector<host_nw_packet_t> trace;
+    host_sleep_sim_result_t result;
+    wake_reason_stats_t wakes;
+    nw_inactivity_info_t window;
+    energy_estimate_t energy;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "t:s:d:nk")))
+    {
+        switch (opt)
+        {
+            case 't': trace_path  = optarg; break;
+            case 's': synthetic   = optarg; break;
+            case 'd': duration_ms = strtoull(optarg, NULL, 10) * 1000; break;
+            case 'n': arp_offload = false; break;
+            case 'k': evict       = false; break;
+            default:
+                fprintf(stderr, "usage: %s [-t trace file | -s quiet|web|lossy|keepalive|chatty|busy] "
+                                "[-d seconds] [-n (no ARP offload)] "
+                                "[-k (keep HTTP connections open)]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if (NULL != trace_path)
+    {
+        if (!host_sleep_sim_load(trace_path, &trace))
+        {
+            fprintf(stderr, "cannot read trace %s\n", trace_path);
+            return 2;
+        }
+        if ((0 == duration_ms) && !trace.empty())
+        {
+            duration_ms = trace.back().time_ms + 1;
+        }
+    }
+    else
+    {
+        if (0 == duration_ms)
+        {
+            duration_ms = SIM_DEFAULT_DURATION_S * 1000;
+        }
+        if (!host_sleep_sim_synthetic(synthetic, duration_ms, &trace))
+        {
+            fprintf(stderr, "unknown trace %s\n", synthetic);
+            return 2;
+        }
+    }
+
+    host_http_init();
+    host_http_keep_connections(!evict);
+    host_sleep_sim_run(trace, duration_ms, arp_offload, &result);
+
+    printf("trace: %s, %zu packets, %llu s, ARP offload %s\n",
+           (NULL != trace_path) ? trace_path : synthetic, trace.size(),
+           (unsigned long long)(result.duration_ms / 1000), arp_offload ? "on" : "off");
+    printf("HTTP connections closed before a suspend: %s, keep-alives not sent: %u\n",
+           evict ? "yes" : "no (-k)", result.keepalives_dropped);
+    printf("NETWORK_INACTIVE_INTERVAL_MS: %u, NETWORK_INACTIVE_WINDOW_MS: %u, adaptive: %u\n",
+           (unsigned)NETWORK_INACTIVE_INTERVAL_MS, (unsigned)NETWORK_INACTIVE_WINDOW_MS,
+           (unsigned)MBED_CONF_APP_NW_INACTIVE_ADAPTIVE);
+    printf("deep sleep with the stack suspended: %llu s (%.1f%%)\n",
+           (unsigned long long)(result.deep_sleep_ms / 1000),
+           (0 == result.duration_ms) ? 0.0 : (100.0 * result.deep_sleep_ms / result.duration_ms));
+    printf("sleep requests: %u, dropped: %u, suspended with the response unacknowledged: %u\n",
+           result.sleep_requests, result.abandoned, result.drain_timeouts);
+    printf("suspend attempts: %u, suspends: %u, timeouts: %u\n",
+           result.suspend_attempts, result.suspends, result.timeouts);
+    printf("ARP requests answered by the WLAN device: %u\n", result.arp_offloaded);
+    for (uint32_t i = 0; i < HOST_NW_PACKET_MAX; i++)
+    {
+        printf("wakes by %-9s packets: %u\n",
+               host_sleep_sim_packet_name((host_nw_packet_kind_t)i), result.wakes[i]);
+    }
+
+    wake_reason_get_stats(&wakes);
+    for (uint32_t i = 0; i < WAKE_REASON_MAX; i++)
+    {
+        printf("wake reason %-9s: %u wakes, %llu ms awake\n",
+               wake_reason_name((wake_reason_t)i), wakes.wakes[i],
+               (unsigned long long)wakes.awake_ms[i]);
+    }
+    for (uint32_t i = 0; (i < WAKE_REASON_PORTS) && (0 != wakes.ports[i].protocol); i++)
+    {
+        printf("wakes by %s port %u: %u\n",
+               (WAKE_REASON_IP_PROTO_TCP == wakes.ports[i].protocol) ? "tcp" : "udp",
+               wakes.ports[i].port, wakes.ports[i].wakes);
+    }
+
+    nw_inactivity_get_info(&window);
+    printf("inactivity window: %u ms in %u ms, idle gap average %u ms, "
+           "awake wait average %u ms\n", window.window_ms, window.interval_ms,
+           window.idle_gap_ewma_ms, window.awake_wait_ewma_ms);
+
+    sim_print_histogram(APP_STATS_HIST_SLEEP_EPISODE);
+    sim_print_histogram(APP_STATS_HIST_SUSPEND_LATENCY);
+    sim_print_histogram(APP_STATS_HIST_RESUME_LATENCY);
+
+    if (energy_model_estimate(&energy))
+    {
+        printf("energy: %u uA average, %u mJ/hour, %u hours battery life\n",
+               energy.avg_current_ua, energy.energy_mj_per_hour, energy.battery_life_hours);
+    }
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
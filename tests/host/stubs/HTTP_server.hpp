@@ -0,0 +1,116 @@
+/******************************************************************************
+ * File Name: HTTP_server.hpp
+ *
+ * Description:
+ *   This file replaces the HTTP server library API used by the application
+ *   with a host implementation that records the registered resources and
+ *   captures the response streams in memory (see host_platform.cpp).
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_HTTP_SERVER_HPP
+#define HOST_HTTP_SERVER_HPP
+
+#include "mbed.h"
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Defined by the host platform; holds the captured response. */
+typedef struct cy_http_response_stream cy_http_response_stream_t;
+
+typedef struct
+{
+    uint8_t  *data;
+    uint16_t  data_length;
+    uint32_t  data_remaining;
+} cy_http_message_body_t;
+
+typedef int32_t (*url_processor_t)(const char* url_path,
+                                   const char* url_query_string,
+                                   cy_http_response_stream_t* stream,
+                                   void* arg,
+                                   cy_http_message_body_t* http_data);
+
+typedef struct
+{
+    url_processor_t  resource_handler;
+    void            *arg;
+} cy_resource_dynamic_data_t;
+
+typedef struct
+{
+    const void *data;
+    uint32_t    length;
+} cy_resource_static_data_t;
+
+typedef enum
+{
+    CY_STATIC_URL_CONTENT,
+    CY_DYNAMIC_URL_CONTENT,
+    CY_RAW_STATIC_URL_CONTENT,
+    CY_RAW_DYNAMIC_URL_CONTENT
+} cy_url_resource_type;
+
+typedef enum
+{
+    CY_NW_INF_TYPE_WIFI
+} cy_network_interface_type_t;
+
+typedef struct
+{
+    void                        *object;
+    cy_network_interface_type_t  type;
+} cy_network_interface_t;
+
+/******************************************************************************
+ *                              CLASS
+ *****************************************************************************/
+class HTTPServer
+{
+public:
+    HTTPServer(cy_network_interface_t *network_interface, uint16_t port, uint16_t max_sockets);
+
+    cy_rslt_t register_resource(uint8_t *url, uint8_t *mime_type,
+                                cy_url_resource_type url_resource_type, void *resource_data);
+    cy_rslt_t start();
+    cy_rslt_t http_response_stream_write(cy_http_response_stream_t *stream,
+                                         const void *data, uint32_t length);
+    cy_rslt_t http_response_stream_flush(cy_http_response_stream_t *stream);
+    cy_rslt_t http_response_stream_disconnect_all();
+};
+
+#endif /* #ifndef HOST_HTTP_SERVER_HPP */
+
+
+/* [] END OF FILE */
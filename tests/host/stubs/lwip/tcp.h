@@ -0,0 +1,66 @@
+/******************************************************************************
+ * File Name: tcp.h
+ *
+ * Description:
+ *   This file replaces the lwIP TCP definitions used for the HTTP socket RAM
+ *   estimate, with the Mbed OS lwIP defaults, and the TCP control block
+ *   fields read to drain the HTTP responses.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_LWIP_TCP_H
+#define HOST_LWIP_TCP_H
+
+#include <stdint.h>
+
+#define TCP_MSS       (536)
+#define TCP_SND_BUF   (2 * TCP_MSS)
+#define TCP_WND       (4 * TCP_MSS)
+
+struct tcp_seg;
+
+/* The fields the application reads, padded to the size on the target. */
+struct tcp_pcb
+{
+    struct tcp_pcb *next;
+    uint16_t        local_port;
+    struct tcp_seg *unsent;
+    struct tcp_seg *unacked;
+    uint16_t        snd_queuelen;
+    uint8_t         opaque[124];
+};
+
+#endif /* #ifndef HOST_LWIP_TCP_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,270 @@
+/******************************************************************************
+ * File Name: mbed.h
+ *
+ * Description:
+ *   This file replaces the parts of the Mbed OS API used by the application,
+ *   so the application modules can be built and run on the host. Atomics,
+ *   memory pools and event flags behave as on the target; the kernel clock is
+ *   a virtual clock driven by the tests (see host_platform.h). The mbed_app.json
+ *   configuration is mirrored below and can be overridden with -D.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_MBED_H
+#define HOST_MBED_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/******************************************************************************
+ *                       mbed_app.json CONFIGURATION
+ *****************************************************************************/
+#ifndef MBED_CONF_APP_HTTP_MAX_SOCKETS
+#define MBED_CONF_APP_HTTP_MAX_SOCKETS            2
+#endif
+#ifndef MBED_CONF_APP_HTTP_RAM_BUDGET
+#define MBED_CONF_APP_HTTP_RAM_BUDGET             32768
+#endif
+#ifndef MBED_CONF_LWIP_SOCKET_MAX
+#define MBED_CONF_LWIP_SOCKET_MAX                 4
+#endif
+#ifndef MBED_CONF_LWIP_TCP_SOCKET_MAX
+#define MBED_CONF_LWIP_TCP_SOCKET_MAX             4
+#endif
+#ifndef MBED_CONF_APP_HTTP_EVICT_BEFORE_SUSPEND
+#define MBED_CONF_APP_HTTP_EVICT_BEFORE_SUSPEND   1
+#endif
+#ifndef MBED_CONF_APP_HTTP_DRAIN_TIMEOUT_MS
+#define MBED_CONF_APP_HTTP_DRAIN_TIMEOUT_MS       1000
+#endif
+#ifndef MBED_CONF_APP_NW_INACTIVE_ADAPTIVE
+#define MBED_CONF_APP_NW_INACTIVE_ADAPTIVE        1
+#endif
+#ifndef MBED_CONF_APP_NW_INACTIVE_WINDOW_MIN_MS
+#define MBED_CONF_APP_NW_INACTIVE_WINDOW_MIN_MS   50
+#endif
+#ifndef MBED_CONF_APP_NW_INACTIVE_WINDOW_MAX_MS
+#define MBED_CONF_APP_NW_INACTIVE_WINDOW_MAX_MS   2000
+#endif
+#ifndef MBED_CONF_APP_NW_SUSPEND_SEARCH_MS
+#define MBED_CONF_APP_NW_SUSPEND_SEARCH_MS        5000
+#endif
+#ifndef MBED_CONF_APP_NW_SUSPEND_BREAK_EVEN_MS
+#define MBED_CONF_APP_NW_SUSPEND_BREAK_EVEN_MS    1000
+#endif
+#ifndef MBED_CONF_APP_ENERGY_MCU_ACTIVE_UA
+#define MBED_CONF_APP_ENERGY_MCU_ACTIVE_UA        6000
+#endif
+#ifndef MBED_CONF_APP_ENERGY_MCU_SLEEP_UA
+#define MBED_CONF_APP_ENERGY_MCU_SLEEP_UA         2500
+#endif
+#ifndef MBED_CONF_APP_ENERGY_MCU_DEEPSLEEP_UA
+#define MBED_CONF_APP_ENERGY_MCU_DEEPSLEEP_UA     10
+#endif
+#ifndef MBED_CONF_APP_ENERGY_WLAN_AWAKE_UA
+#define MBED_CONF_APP_ENERGY_WLAN_AWAKE_UA        4000
+#endif
+#ifndef MBED_CONF_APP_ENERGY_WLAN_OFFLOAD_UA
+#define MBED_CONF_APP_ENERGY_WLAN_OFFLOAD_UA      1000
+#endif
+#ifndef MBED_CONF_APP_ENERGY_SUPPLY_MV
+#define MBED_CONF_APP_ENERGY_SUPPLY_MV            3300
+#endif
+#ifndef MBED_CONF_APP_ENERGY_BATTERY_MAH
+#define MBED_CONF_APP_ENERGY_BATTERY_MAH          1000
+#endif
+
+#define MBED_CPU_STATS_ENABLED
+
+/******************************************************************************
+ *                                PLATFORM
+ *****************************************************************************/
+typedef uint32_t cy_rslt_t;
+typedef uint64_t us_timestamp_t;
+
+#define CY_RSLT_SUCCESS               ((cy_rslt_t)0u)
+#define CY_RSLT_TYPE_ERROR            ((cy_rslt_t)0x80000000u)
+
+#define osWaitForever                 0xFFFFFFFFu
+
+#define MBED_ASSERT(expr)             do { if (!(expr)) { abort(); } } while (0)
+#define MBED_STATIC_ASSERT(expr, msg) static_assert(expr, msg)
+#define MBED_STRINGIFY2(a)            #a
+#define MBED_STRINGIFY(a)             MBED_STRINGIFY2(a)
+
+us_timestamp_t mbed_uptime(void);
+us_timestamp_t mbed_time_idle(void);
+us_timestamp_t mbed_time_sleep(void);
+us_timestamp_t mbed_time_deepsleep(void);
+
+#define HOST_ATOMIC_OPS(name, type)                                                                 \
+static inline type core_util_atomic_load_##name(const volatile type *p)                             \
+{ return __atomic_load_n(p, __ATOMIC_SEQ_CST); }                                                    \
+static inline void core_util_atomic_store_##name(volatile type *p, type v)                          \
+{ __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }                                                       \
+static inline type core_util_atomic_exchange_##name(volatile type *p, type v)                       \
+{ return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }                                             \
+static inline bool core_util_atomic_cas_##name(volatile type *p, type *expected, type desired)      \
+{ return __atomic_compare_exchange_n(p, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
+
+HOST_ATOMIC_OPS(u32, uint32_t)
+HOST_ATOMIC_OPS(u64, uint64_t)
+HOST_ATOMIC_OPS(bool, bool)
+
+static inline uint32_t core_util_atomic_incr_u32(volatile uint32_t *p, uint32_t v)
+{ return __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST); }
+static inline uint32_t core_util_atomic_decr_u32(volatile uint32_t *p, uint32_t v)
+{ return __atomic_sub_fetch(p, v, __ATOMIC_SEQ_CST); }
+static inline uint64_t core_util_atomic_incr_u64(volatile uint64_t *p, uint64_t v)
+{ return __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST); }
+
+/******************************************************************************
+ *                                   RTOS
+ *****************************************************************************/
+namespace rtos {
+
+namespace Kernel {
+/* Virtual clock in milliseconds, set and advanced by the tests. */
+struct Clock
+{
+    typedef std::chrono::milliseconds                  duration;
+    typedef std::chrono::duration<uint32_t, std::milli> duration_u32;
+    typedef std::chrono::time_point<Clock, duration>   time_point;
+    static time_point now();
+};
+} /* namespace Kernel */
+
+namespace ThisThread {
+/* Advances the virtual clock instead of blocking. */
+void sleep_for(Kernel::Clock::duration_u32 rel_time);
+} /* namespace ThisThread */
+
+class EventFlags
+{
+public:
+    uint32_t set(uint32_t flags)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _flags |= flags;
+        _cond.notify_all();
+        return _flags;
+    }
+
+    uint32_t clear(uint32_t flags = 0x7FFFFFFFu)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        uint32_t old = _flags;
+        _flags &= ~flags;
+        return old;
+    }
+
+    uint32_t get() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _flags;
+    }
+
+    uint32_t wait_any(uint32_t flags, uint32_t millisec = osWaitForever, bool clear = true)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        uint32_t set_flags;
+
+        (void)millisec;
+        _cond.wait(lock, [&] { return 0 != (_flags & flags); });
+        set_flags = _flags;
+        if (clear)
+        {
+            _flags &= ~flags;
+        }
+        return set_flags;
+    }
+
+private:
+    mutable std::mutex      _mutex;
+    std::condition_variable _cond;
+    uint32_t                _flags = 0;
+};
+
+template<typename T, uint32_t pool_sz>
+class MemoryPool
+{
+public:
+    T *try_alloc()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (uint32_t i = 0; i < pool_sz; i++)
+        {
+            if (!_used[i])
+            {
+                _used[i] = true;
+                return &_blocks[i];
+            }
+        }
+        return NULL;
+    }
+
+    int free(T *block)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _used[block - _blocks] = false;
+        return 0;
+    }
+
+private:
+    std::mutex _mutex;
+    T          _blocks[pool_sz];
+    bool       _used[pool_sz] = {};
+};
+
+} /* namespace rtos */
+
+using namespace rtos;
+
+/******************************************************************************
+ *                                NETSOCKET
+ *****************************************************************************/
+class SocketAddress
+{
+public:
+    const char *get_ip_address() const;
+};
+
+#endif /* #ifndef HOST_MBED_H */
+
+
+/* [] END OF FILE */
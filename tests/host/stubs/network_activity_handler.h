@@ -0,0 +1,61 @@
+/******************************************************************************
+ * File Name: network_activity_handler.h
+ *
+ * Description:
+ *   This file replaces the LPA network activity handler API used by the
+ *   application.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_NETWORK_ACTIVITY_HANDLER_H
+#define HOST_NETWORK_ACTIVITY_HANDLER_H
+
+#include "mbed.h"
+
+#define ST_SUCCESS                          (0)
+#define ST_WAIT_TIMEOUT_EXPIRED             (1)
+#define ST_WAIT_INACTIVITY_TIMEOUT_EXPIRED  (2)
+#define ST_WAIT_ABORTED                     (3)
+#define ST_BAD_ARGS                         (4)
+#define ST_BAD_STATE                        (5)
+
+extern us_timestamp_t cy_dsleep_nw_suspend_time;
+
+int32_t wait_net_suspend(void *net_intf, uint32_t wait_ms,
+                         uint32_t network_inactive_interval_ms,
+                         uint32_t network_inactive_window_ms);
+
+#endif /* #ifndef HOST_NETWORK_ACTIVITY_HANDLER_H */
+
+
+/* [] END OF FILE */
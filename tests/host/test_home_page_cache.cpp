@@ -0,0 +1,157 @@
+/******************************************************************************
+ * File Name: test_home_page_cache.cpp
+ *
+ * Description:
+ *   This file contains the host test of the caching headers of the home
+ *   page. It replays a browser that loads the home page and then revisits
+ *   it, with the HTTP caching rules a browser applies to the headers of the
+ *   first response, and checks that the revisit reaches the kit: loading the
+ *   home page is how a user wakes the host.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string>
+#include "host_platform.h"
+#include "http_webserver_config.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Browser cache entry for one URL. */
+typedef struct
+{
+    bool        stored;
+    std::string headers;
+    std::string body;
+} browser_cache_entry_t;
+
+/* How the browser answered a visit. */
+typedef enum
+{
+    BROWSER_FROM_CACHE,      /* Served from the cache; no request sent. */
+    BROWSER_REVALIDATED,     /* Conditional request answered with 304. */
+    BROWSER_FULL_RESPONSE    /* Request answered with the full page. */
+} browser_visit_t;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Value of a response header, or an empty string if it is not present. */
+static std::string browser_header(const std::string &headers, const char *name)
+{
+    std::string key = std::string("\r\n") + name + ": ";
+    size_t start = headers.find(key);
+    size_t end;
+
+    if (std::string::npos == start)
+    {
+        return "";
+    }
+    start += key.size();
+    end = headers.find("\r\n", start);
+    return headers.substr(start, end - start);
+}
+
+/* Visits 'url' as a browser would with the cache entry of an earlier visit:
+ * a fresh entry is used without a request; an entry that must be revalidated
+ * is sent with its validator, if it has one; anything else is a full request.
+ */
+static browser_visit_t browser_visit(const char *url, browser_cache_entry_t *entry,
+                                     uint32_t *bytes_received)
+{
+    cy_http_response_stream_t stream;
+    std::string cache_control;
+    size_t header_end;
+
+    *bytes_received = 0;
+    if (entry->stored)
+    {
+        cache_control = browser_header(entry->headers, "Cache-Control");
+        if ((std::string::npos == cache_control.find("no-cache")) &&
+            (std::string::npos != cache_control.find("max-age=")))
+        {
+            return BROWSER_FROM_CACHE;
+        }
+    }
+
+    /* The HTTP server library does not pass If-None-Match to the handler,
+     * so a conditional request is served like any other.
+     */
+    CHECK_EQ(host_http_request(url, &stream, NULL), CY_RSLT_SUCCESS);
+    *bytes_received = stream.body.size();
+
+    header_end = stream.body.find("\r\n\r\n");
+    CHECK(std::string::npos != header_end);
+    if (0 == stream.body.compare(0, 12, "HTTP/1.1 304"))
+    {
+        return BROWSER_REVALIDATED;
+    }
+
+    entry->stored  = (std::string::npos == browser_header(stream.body, "Cache-Control").find("no-store"));
+    entry->headers = stream.body.substr(0, header_end + 2);
+    entry->body    = stream.body.substr(header_end + 4);
+    return BROWSER_FULL_RESPONSE;
+}
+
+int main(void)
+{
+    browser_cache_entry_t entry = {};
+    uint32_t first_bytes;
+    uint32_t revisit_bytes;
+
+    host_http_init();
+
+    CHECK_EQ(browser_visit("/", &entry, &first_bytes), BROWSER_FULL_RESPONSE);
+    CHECK(entry.stored);
+    CHECK(!entry.body.empty());
+
+    /* The page may be stored but must be revalidated on every visit, and it
+     * has no validator, so a revisit is a full request sent to the kit.
+     */
+    CHECK(browser_header(entry.headers, "Cache-Control") == "no-cache");
+    CHECK(browser_header(entry.headers, "ETag").empty());
+    CHECK(browser_header(entry.headers, "Last-Modified").empty());
+    CHECK(browser_header(entry.headers, "Expires").empty());
+
+    for (uint32_t visit = 0; visit < 3; visit++)
+    {
+        CHECK_EQ(browser_visit("/", &entry, &revisit_bytes), BROWSER_FULL_RESPONSE);
+        CHECK_EQ(revisit_bytes, first_bytes);
+    }
+
+    return TEST_RESULT("test_home_page_cache");
+}
+
+
+/* [] END OF FILE */
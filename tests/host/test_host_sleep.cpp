@@ -0,0 +1,158 @@
+/******************************************************************************
+ * File Name: test_host_sleep.cpp
+ *
+ * Description:
+ *   This file contains the host test of the host sleep state machine.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "host_platform.h"
+#include "host_sleep.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static host_sleep_state_t get_state(host_sleep_info_t *info)
+{
+    host_sleep_get_info(info);
+    return info->state;
+}
+
+int main(void)
+{
+    host_sleep_info_t info;
+
+    host_clock_set_ms(1000);
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_AWAKE);
+
+    /* A request while awake starts a suspend; one while it is pending is
+     * merged with it.
+     */
+    CHECK(host_sleep_request());
+    CHECK(!host_sleep_request());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_PENDING_SUSPEND);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_PENDING_SUSPEND], 1000u);
+    CHECK_EQ(info.requests_coalesced, 1u);
+
+    host_sleep_wait_request();
+    CHECK_EQ(host_clock_now_ms(), 1000u);
+
+    /* The search for an inactive window is still part of PENDING_SUSPEND;
+     * a search that finds none goes back to AWAKE and never enters
+     * SUSPENDED.
+     */
+    host_sleep_searching();
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_PENDING_SUSPEND);
+    host_clock_advance_ms(5000);
+    CHECK(!host_sleep_resumed());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_AWAKE);
+    CHECK_EQ(info.resumed_ms, 6000u);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_AWAKE], 6000u);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_SUSPENDED], 0u);
+    CHECK_EQ(info.requests_rearmed, 0u);
+
+    /* A suspend is recorded once the stack resumes, with the times the
+     * stack was suspended and the wake frame arrived.
+     */
+    CHECK(host_sleep_request());
+    host_sleep_wait_request();
+    host_sleep_searching();
+    host_clock_advance_ms(3000);
+    host_sleep_suspended(host_clock_now_ms() - 2000, host_clock_now_ms() - 5);
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_RESUMING);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_SUSPENDED], host_clock_now_ms() - 2000);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_RESUMING], host_clock_now_ms() - 5);
+    CHECK(!host_sleep_resumed());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_AWAKE);
+
+    /* A request during the search is merged with it, but not dropped: the
+     * state machine starts a new suspend when the running one ends.
+     */
+    CHECK(host_sleep_request());
+    host_sleep_wait_request();
+    host_sleep_searching();
+    CHECK(!host_sleep_request());
+    CHECK(!host_sleep_request());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_PENDING_SUSPEND);
+    CHECK_EQ(info.requests_coalesced, 3u);
+
+    host_clock_advance_ms(1000);
+    host_sleep_suspended(host_clock_now_ms() - 500, host_clock_now_ms());
+    CHECK(!host_sleep_request());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_RESUMING);
+    CHECK(host_sleep_resumed());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_PENDING_SUSPEND);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_PENDING_SUSPEND], host_clock_now_ms());
+    CHECK_EQ(info.requests_coalesced, 4u);
+    CHECK_EQ(info.requests_rearmed, 1u);
+
+    /* The re-armed request wakes the sleep thread at once, and the next
+     * suspend ends normally.
+     */
+    host_sleep_wait_request();
+    host_sleep_searching();
+    CHECK(!host_sleep_resumed());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_AWAKE);
+    CHECK_EQ(info.requests_rearmed, 1u);
+
+    /* The wake frame moves the state machine to RESUMING while the sleep
+     * thread is still in wait_net_suspend(); the sleep thread then only
+     * updates the time of the suspend. A wake frame outside the search is
+     * ignored.
+     */
+    CHECK(!host_sleep_resuming(host_clock_now_ms(), host_clock_now_ms()));
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_AWAKE);
+    CHECK(host_sleep_request());
+    host_sleep_wait_request();
+    host_sleep_searching();
+    host_clock_advance_ms(4000);
+    CHECK(host_sleep_resuming(host_clock_now_ms() - 3000, host_clock_now_ms()));
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_RESUMING);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_SUSPENDED], host_clock_now_ms() - 3000);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_RESUMING], host_clock_now_ms());
+    CHECK(!host_sleep_resuming(host_clock_now_ms(), host_clock_now_ms()));
+
+    host_clock_advance_ms(20);
+    host_sleep_suspended(host_clock_now_ms() - 3100, host_clock_now_ms());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_RESUMING);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_SUSPENDED], host_clock_now_ms() - 3100);
+    CHECK_EQ(info.entered_ms[HOST_SLEEP_STATE_RESUMING], host_clock_now_ms() - 20);
+    CHECK(!host_sleep_resumed());
+    CHECK_EQ(get_state(&info), HOST_SLEEP_STATE_AWAKE);
+
+    return TEST_RESULT("test_host_sleep");
+}
+
+
+/* [] END OF FILE */
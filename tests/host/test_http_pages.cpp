@@ -0,0 +1,203 @@
+/******************************************************************************
+ * File Name: test_http_pages.cpp
+ *
+ * Description:
+ *   This file contains the host test of the HTTP resources. Every registered
+ *   URL is requested through the route table, as the HTTP server library does,
+ *   and the responses are checked.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string>
+#include "host_platform.h"
+#include "http_webserver_config.h"
+#include "http_response_pool.h"
+#include "wake_reason.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static std::string request(const char *url, int32_t *result)
+{
+    cy_http_response_stream_t stream;
+
+    *result = host_http_request(url, &stream, NULL);
+    return stream.body;
+}
+
+/* Time the client ACKs the response in the drain test. */
+static uint64_t ack_ms;
+
+static void ack_at(uint64_t until_ms)
+{
+    if (until_ms >= ack_ms)
+    {
+        host_http_acked();
+    }
+}
+
+static bool ends_with(const std::string &str, const std::string &suffix)
+{
+    return (str.size() >= suffix.size()) &&
+           (0 == str.compare(str.size() - suffix.size(), suffix.size(), suffix));
+}
+
+int main(void)
+{
+    /* TCP SYN from 192.168.0.1 to port 80 of the device. */
+    static const uint8_t http_syn[] = {
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x05, 0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x08, 0x00,
+        0x45, 0x00, 0x00, 0x28, 0x00, 0x00, 0x40, 0x00, 0x40, 0x06, 0x00, 0x00,
+        0xC0, 0xA8, 0x00, 0x01, 0xC0, 0xA8, 0x00, 0x05,
+        0xC3, 0x50, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x50, 0x02, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00
+    };
+    int32_t result;
+    std::string body;
+    cy_http_response_stream_t failing;
+    cy_http_response_stream_t json_stream;
+    http_response_pool_stats_t pool_stats;
+    wake_reason_stats_t wake_stats;
+    uint64_t start_ms;
+
+    host_set_cpu_stats(3600000000ULL, 3000000000ULL, 500000000ULL, 2400000000ULL);
+    host_http_init();
+
+    /* Home page: the raw response kept in flash. */
+    body = request("/", &result);
+    CHECK_EQ(result, CY_RSLT_SUCCESS);
+    CHECK(0 == body.compare(0, 15, "HTTP/1.1 200 OK"));
+    CHECK(std::string::npos != body.find("\r\nCache-Control: no-cache\r\n"));
+
+    /* Sleep and wake pages carry the IP address of the kit. */
+    body = request("/sleep", &result);
+    CHECK_EQ(result, CY_RSLT_SUCCESS);
+    CHECK(std::string::npos != body.find("<a href=\"http://192.168.0.5\">Wake Host</a>"));
+    CHECK(ends_with(body, "</html>"));
+
+    body = request("/wake", &result);
+    CHECK_EQ(result, CY_RSLT_SUCCESS);
+    CHECK(std::string::npos != body.find("url=http://192.168.0.5\"/>"));
+
+    /* Statistics in HTML, JSON and OpenMetrics. */
+    body = request("/stats", &result);
+    CHECK_EQ(result, CY_RSLT_SUCCESS);
+    CHECK(std::string::npos != body.find("uptime(hh:mm:ss)\t:1:0:0"));
+    CHECK(ends_with(body, "</textarea></body></html>"));
+
+    body = request("/stats.json", &result);
+    CHECK_EQ(result, CY_RSLT_SUCCESS);
+    CHECK(0 == body.compare(0, 21, "{\"uptime\":3600000000,"));
+    CHECK(ends_with(body, "}"));
+
+    body = request("/metrics", &result);
+    CHECK_EQ(result, CY_RSLT_SUCCESS);
+    CHECK(std::string::npos != body.find("arp_ol_uptime_seconds_total 3600.000000\n"));
+    CHECK(ends_with(body, "# EOF\n"));
+
+    /* Closing the connections before a suspend counts one pass, however
+     * many connections were open.
+     */
+    app_http_server_evict_connections();
+    CHECK_EQ(host_http_disconnect_all_count(), 1u);
+    body = request("/metrics", &result);
+    CHECK(std::string::npos != body.find("arp_ol_http_eviction_passes_total 1\n"));
+
+    /* Peak RAM per page: the JSON document with its NUL terminator in a
+     * pool buffer, and at most one stream buffer chunk for the others.
+     */
+    host_http_request("/stats.json", &json_stream, NULL);
+    http_response_pool_get_stats(&pool_stats);
+    CHECK_EQ(pool_stats.page_peak_bytes[HTTP_RESPONSE_PAGE_STATS_JSON], json_stream.body.size() + 1);
+    CHECK_EQ(pool_stats.peak_bytes, json_stream.body.size() + 1);
+    CHECK(0 != pool_stats.page_peak_bytes[HTTP_RESPONSE_PAGE_STATS]);
+    CHECK(pool_stats.page_peak_bytes[HTTP_RESPONSE_PAGE_STATS] <= HTTP_STREAM_CHUNK_LEN);
+    CHECK_EQ(pool_stats.page_peak_bytes[HTTP_RESPONSE_PAGE_METRICS], HTTP_STREAM_CHUNK_LEN);
+    CHECK_EQ(pool_stats.peak_chunk_bytes, HTTP_STREAM_CHUNK_LEN);
+    CHECK_EQ(pool_stats.in_use, 0u);
+    body = request("/stats", &result);
+    CHECK(std::string::npos != body.find("\n\t/stats.json\t\t:"));
+
+    /* A TCP SYN to the HTTP server after an inactive window resumes the
+     * stack, and is counted under TCP port 80; a resume without a frame is
+     * attributed to a timer.
+     */
+    wake_reason_watch(100);
+    host_clock_advance_ms(100);
+    host_nw_receive(http_syn, sizeof(http_syn));
+    wake_reason_resumed();
+    wake_reason_suspending();
+    wake_reason_watch(100);
+    wake_reason_resumed();
+    wake_reason_suspending();
+    wake_reason_get_stats(&wake_stats);
+    CHECK_EQ(wake_stats.wakes[WAKE_REASON_TCP], 1u);
+    CHECK_EQ(wake_stats.wakes[WAKE_REASON_TIMER], 1u);
+    body = request("/metrics", &result);
+    CHECK(std::string::npos != body.find("arp_ol_wakes_total{reason=\"timer\"} 1\n"));
+    CHECK(std::string::npos != body.find("arp_ol_wake_ports_total{protocol=\"tcp\",port=\"80\"} 1\n"));
+
+    /* The sleep thread waits for the responses to be acknowledged, polling
+     * every HTTP_DRAIN_POLL_MS, and counts the suspends that go ahead without
+     * the ACK.
+     */
+    start_ms = host_clock_now_ms();
+    CHECK(app_http_server_drain_responses(1000));
+    CHECK_EQ(host_clock_now_ms(), start_ms);
+    host_http_sent();
+    ack_ms = start_ms + 25;
+    host_set_thread_sleep_hook(ack_at);
+    CHECK(app_http_server_drain_responses(1000));
+    CHECK_EQ(host_clock_now_ms(), start_ms + (3 * HTTP_DRAIN_POLL_MS));
+    host_set_thread_sleep_hook(NULL);
+    host_http_sent();
+    CHECK(!app_http_server_drain_responses(100));
+    CHECK_EQ(host_clock_now_ms(), start_ms + (3 * HTTP_DRAIN_POLL_MS) + 100);
+    host_http_acked();
+    body = request("/metrics", &result);
+    CHECK(std::string::npos != body.find("arp_ol_http_drain_timeouts_total 1\n"));
+
+    /* Unknown URLs are not served. */
+    request("/missing", &result);
+    CHECK(CY_RSLT_SUCCESS != result);
+
+    /* A write error is returned by the handler. */
+    failing.fail_at_write = 1;
+    CHECK(CY_RSLT_SUCCESS != host_http_request("/stats", &failing, NULL));
+
+    return TEST_RESULT("test_http_pages");
+}
+
+
+/* [] END OF FILE */
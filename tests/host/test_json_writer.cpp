@@ -0,0 +1,137 @@
+/******************************************************************************
+ * File Name: test_json_writer.cpp
+ *
+ * Description:
+ *   This file contains the host test of the JSON writer.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "json_writer.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void test_members(void)
+{
+    char buf[128];
+    json_writer_t json;
+
+    json_writer_init(&json, buf, sizeof(buf));
+    json_writer_begin_object(&json);
+    json_writer_add_uint64(&json, "zero", 0);
+    json_writer_add_uint64(&json, "max", UINT64_MAX);
+    json_writer_add_string(&json, "state", "pending-suspend");
+    json_writer_add_uint64(&json, "one", 1);
+    json_writer_end_object(&json);
+
+    CHECK(json_writer_ok(&json));
+    CHECK(0 == strcmp(buf, "{\"zero\":0,\"max\":18446744073709551615,"
+                           "\"state\":\"pending-suspend\",\"one\":1}"));
+    CHECK_EQ(json.length, strlen(buf));
+}
+
+static void test_empty_object(void)
+{
+    char buf[8];
+    json_writer_t json;
+
+    json_writer_init(&json, buf, sizeof(buf));
+    json_writer_begin_object(&json);
+    json_writer_end_object(&json);
+
+    CHECK(json_writer_ok(&json));
+    CHECK(0 == strcmp(buf, "{}"));
+}
+
+static void test_exact_fit(void)
+{
+    /* "{\"a\":1}" is 7 characters plus the NUL terminator. */
+    char buf[8];
+    json_writer_t json;
+
+    json_writer_init(&json, buf, sizeof(buf));
+    json_writer_begin_object(&json);
+    json_writer_add_uint64(&json, "a", 1);
+    json_writer_end_object(&json);
+
+    CHECK(json_writer_ok(&json));
+    CHECK(0 == strcmp(buf, "{\"a\":1}"));
+}
+
+static void test_overflow(void)
+{
+    char buf[16];
+    json_writer_t json;
+
+    json_writer_init(&json, buf, sizeof(buf));
+    json_writer_begin_object(&json);
+    json_writer_add_uint64(&json, "a", 1);
+    json_writer_add_uint64(&json, "max", UINT64_MAX);
+    json_writer_add_string(&json, "s", "x");
+    json_writer_end_object(&json);
+
+    /* Output stops at the first fragment that does not fit, and the buffer
+     * stays NUL terminated.
+     */
+    CHECK(!json_writer_ok(&json));
+    CHECK(json.length < sizeof(buf));
+    CHECK_EQ(strlen(buf), json.length);
+    CHECK(0 == strncmp(buf, "{\"a\":1,\"max\":", json.length));
+}
+
+static void test_no_buffer(void)
+{
+    json_writer_t json;
+
+    json_writer_init(&json, NULL, 0);
+    json_writer_begin_object(&json);
+    json_writer_end_object(&json);
+
+    CHECK(!json_writer_ok(&json));
+}
+
+int main(void)
+{
+    test_members();
+    test_empty_object();
+    test_exact_fit();
+    test_overflow();
+    test_no_buffer();
+
+    return TEST_RESULT("test_json_writer");
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * File Name: test_log2_histogram.cpp
+ *
+ * Description:
+ *   This file contains the host test of the log2 histograms. Synthetic sleep
+ *   episodes and resumes are recorded and the buckets they land in are
+ *   checked against a reference.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string>
+#include "host_platform.h"
+#include "app_stats.h"
+#include "log2_histogram.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define EPISODE_COUNT    (1000u)
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Reference bucket: the smallest i with value < 2^i, clamped to the last. */
+static uint32_t reference_bucket(uint32_t value)
+{
+    uint32_t bucket = 0;
+
+    while ((bucket < (LOG2_HISTOGRAM_BUCKETS - 1)) && ((uint64_t)value >= (1ULL << bucket)))
+    {
+        bucket++;
+    }
+
+    return bucket;
+}
+
+static void test_bucket_bounds(void)
+{
+    static const uint32_t values[] = {
+        0, 1, 2, 3, 4, 7, 8, 1000, 65535, 65536, 262144, 10800000,
+        (1UL << 30) - 1, (1UL << 30), UINT32_MAX
+    };
+    log2_histogram_t hist = {};
+    log2_histogram_t snapshot;
+    log2_histogram_t expected = {};
+
+    for (uint32_t value : values)
+    {
+        log2_histogram_record(&hist, value);
+        expected.counts[reference_bucket(value)]++;
+
+        /* Every value lies inside the bounds of its bucket. */
+        CHECK(value >= log2_histogram_bucket_min(reference_bucket(value)));
+    }
+
+    log2_histogram_get(&hist, &snapshot);
+    for (uint32_t i = 0; i < LOG2_HISTOGRAM_BUCKETS; i++)
+    {
+        CHECK_EQ(snapshot.counts[i], expected.counts[i]);
+    }
+
+    /* A three-hour episode has a bucket of its own, below the last one. */
+    CHECK(reference_bucket(10800000) < (LOG2_HISTOGRAM_BUCKETS - 1));
+    CHECK_EQ(snapshot.counts[LOG2_HISTOGRAM_BUCKETS - 1], 2u);
+    CHECK_EQ(log2_histogram_bucket_min(LOG2_HISTOGRAM_BUCKETS - 1), 1UL << 30);
+}
+
+static void test_sleep_episodes(void)
+{
+    log2_histogram_t snapshot;
+    log2_histogram_t expected = {};
+    uint32_t seed = 1;
+    uint32_t episode_ms;
+    uint32_t total = 0;
+
+    /* Episodes from a few milliseconds to about a day, spread over all the
+     * octaves.
+     */
+    for (uint32_t i = 0; i < EPISODE_COUNT; i++)
+    {
+        seed = (seed * 1103515245u) + 12345u;
+        episode_ms = (seed >> 4) >> ((seed >> 27) % 28u);
+        app_stats_record(APP_STATS_HIST_SLEEP_EPISODE, episode_ms);
+        expected.counts[reference_bucket(episode_ms)]++;
+    }
+
+    app_stats_get_histogram(APP_STATS_HIST_SLEEP_EPISODE, &snapshot);
+    for (uint32_t i = 0; i < LOG2_HISTOGRAM_BUCKETS; i++)
+    {
+        CHECK_EQ(snapshot.counts[i], expected.counts[i]);
+        total += snapshot.counts[i];
+    }
+    CHECK_EQ(total, EPISODE_COUNT);
+}
+
+static void test_stats_page(void)
+{
+    cy_http_response_stream_t stream;
+
+    /* The page lists the non-empty buckets with their bounds. */
+    app_stats_record(APP_STATS_HIST_SUSPEND_LATENCY, 300);
+    app_stats_record(APP_STATS_HIST_SUSPEND_LATENCY, UINT32_MAX);
+    host_http_request("/stats", &stream, NULL);
+    CHECK(std::string::npos != stream.body.find("\nSuspend latency(ms):"
+                                                "\n\t256 - 511\t:1"
+                                                "\n\t1073741824 and above\t:1"
+                                                "\nResume latency(ms):"));
+}
+
+int main(void)
+{
+    host_clock_set_ms(1000);
+    host_http_init();
+
+    test_bucket_bounds();
+    test_sleep_episodes();
+    test_stats_page();
+
+    return TEST_RESULT("test_log2_histogram");
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,386 @@
+/******************************************************************************
+ * File Name: test_metrics.cpp
+ *
+ * Description:
+ *   This file contains the host test of the /metrics resource. The page is
+ *   served with the OpenMetrics content type, so its body is parsed with the
+ *   rules of the OpenMetrics text format: every metric family starts with
+ *   its TYPE, its metadata comes before its samples, names and labels are
+ *   well formed, counters end in '_total', and '# EOF' is the last line.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include <string>
+#include "host_platform.h"
+#include "http_webserver_config.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Parser state for the metric family being read. */
+typedef struct
+{
+    std::string           name;
+    std::string           type;
+    bool                  has_unit;
+    bool                  has_help;
+    bool                  has_samples;
+    std::set<std::string> samples;
+} metrics_family_t;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static bool metrics_is_name(const std::string &name, bool allow_colon)
+{
+    if (name.empty() || isdigit((unsigned char)name[0]))
+    {
+        return false;
+    }
+    for (char c : name)
+    {
+        if (!isalnum((unsigned char)c) && ('_' != c) && (!allow_colon || (':' != c)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool metrics_is_type(const std::string &type)
+{
+    static const char *const types[] = {
+        "counter", "gauge", "stateset", "info", "histogram", "gaugehistogram",
+        "summary", "unknown"
+    };
+
+    for (const char *t : types)
+    {
+        if (type == t)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool metrics_ends_with(const std::string &str, const std::string &suffix)
+{
+    return (str.size() >= suffix.size()) &&
+           (0 == str.compare(str.size() - suffix.size(), suffix.size(), suffix));
+}
+
+/* Parses the label set at the start of 'labels', up to and including '}'.
+ * Returns the number of characters used, or 0 if the set is malformed.
+ */
+static size_t metrics_parse_labels(const std::string &labels)
+{
+    std::set<std::string> names;
+    size_t pos = 1;
+
+    if ((labels.size() < 2) || ('{' != labels[0]))
+    {
+        return 0;
+    }
+    while ((pos < labels.size()) && ('}' != labels[pos]))
+    {
+        size_t eq = labels.find('=', pos);
+        std::string name;
+
+        if (std::string::npos == eq)
+        {
+            return 0;
+        }
+        name = labels.substr(pos, eq - pos);
+        if (!metrics_is_name(name, false) || !names.insert(name).second ||
+            ((eq + 1) >= labels.size()) || ('"' != labels[eq + 1]))
+        {
+            return 0;
+        }
+        for (pos = eq + 2; (pos < labels.size()) && ('"' != labels[pos]); pos++)
+        {
+            if ('\\' == labels[pos])
+            {
+                pos++;
+                if ((pos >= labels.size()) || (NULL == strchr("\\\"n", labels[pos])))
+                {
+                    return 0;
+                }
+            }
+        }
+        if (pos >= labels.size())
+        {
+            return 0;
+        }
+        pos++;
+        if ((pos < labels.size()) && (',' == labels[pos]))
+        {
+            pos++;
+        }
+    }
+    return (pos < labels.size()) ? (pos + 1) : 0;
+}
+
+static bool metrics_is_value(const std::string &value)
+{
+    char *end = NULL;
+
+    if (value.empty())
+    {
+        return false;
+    }
+    if (("NaN" == value) || ("+Inf" == value) || ("-Inf" == value))
+    {
+        return true;
+    }
+    strtod(value.c_str(), &end);
+    return ('\0' == *end);
+}
+
+/* Checks a body against the OpenMetrics text format. On failure, 'error'
+ * describes the first offending line.
+ */
+static bool metrics_validate(const std::string &body, std::string *error)
+{
+    std::set<std::string> families;
+    metrics_family_t family;
+    bool eof = false;
+    size_t start = 0;
+    uint32_t line_number = 0;
+
+    family.has_samples = false;
+    while (start < body.size())
+    {
+        size_t end = body.find('\n', start);
+        std::string line;
+
+        line_number++;
+        *error = "line " + std::to_string(line_number) + ": ";
+        if (eof)
+        {
+            *error += "data after # EOF";
+            return false;
+        }
+        if (std::string::npos == end)
+        {
+            *error += "no line feed";
+            return false;
+        }
+        line = body.substr(start, end - start);
+        start = end + 1;
+
+        if ("# EOF" == line)
+        {
+            eof = true;
+        }
+        else if (0 == line.compare(0, 2, "# "))
+        {
+            size_t name_start = line.find(' ', 2);
+            size_t name_end = (std::string::npos == name_start) ? std::string::npos :
+                              line.find(' ', name_start + 1);
+            std::string keyword = line.substr(2, name_start - 2);
+            std::string name;
+            std::string text;
+
+            if (std::string::npos == name_end)
+            {
+                *error += "metadata without a value";
+                return false;
+            }
+            name = line.substr(name_start + 1, name_end - name_start - 1);
+            text = line.substr(name_end + 1);
+
+            if ("TYPE" == keyword)
+            {
+                if (!metrics_is_name(name, true) || !families.insert(name).second)
+                {
+                    *error += "bad or repeated metric family '" + name + "'";
+                    return false;
+                }
+                if (!metrics_is_type(text) ||
+                    (("counter" == text) && metrics_ends_with(name, "_total")))
+                {
+                    *error += "bad type '" + text + "' of '" + name + "'";
+                    return false;
+                }
+                family = metrics_family_t();
+                family.name = name;
+                family.type = text;
+            }
+            else if ((name != family.name) || family.has_samples)
+            {
+                *error += keyword + " of '" + name + "' outside its family metadata";
+                return false;
+            }
+            else if ("UNIT" == keyword)
+            {
+                if (family.has_unit || !metrics_ends_with(name, "_" + text))
+                {
+                    *error += "bad unit '" + text + "' of '" + name + "'";
+                    return false;
+                }
+                family.has_unit = true;
+            }
+            else if ("HELP" == keyword)
+            {
+                if (family.has_help)
+                {
+                    *error += "repeated HELP of '" + name + "'";
+                    return false;
+                }
+                family.has_help = true;
+            }
+            else
+            {
+                *error += "unknown metadata '" + keyword + "'";
+                return false;
+            }
+        }
+        else
+        {
+            size_t name_end = line.find_first_of("{ ");
+            std::string name = line.substr(0, name_end);
+            std::string suffix;
+            size_t labels_len = 0;
+            size_t value_start;
+            std::string value;
+
+            if (family.name.empty() || (0 != name.compare(0, family.name.size(), family.name)))
+            {
+                *error += "sample '" + name + "' outside its family";
+                return false;
+            }
+            suffix = name.substr(family.name.size());
+            if ((("counter" == family.type) && ("_total" != suffix) && ("_created" != suffix)) ||
+                ((("gauge" == family.type) || ("unknown" == family.type)) && !suffix.empty()))
+            {
+                *error += "sample '" + name + "' does not match the " + family.type + " '" +
+                          family.name + "'";
+                return false;
+            }
+            if ((std::string::npos != name_end) && ('{' == line[name_end]))
+            {
+                labels_len = metrics_parse_labels(line.substr(name_end));
+                if (0 == labels_len)
+                {
+                    *error += "bad labels of '" + name + "'";
+                    return false;
+                }
+            }
+            value_start = name.size() + labels_len;
+            if ((value_start >= line.size()) || (' ' != line[value_start]))
+            {
+                *error += "no value for '" + name + "'";
+                return false;
+            }
+            value = line.substr(value_start + 1);
+            if (!metrics_is_value(value) ||
+                (("counter" == family.type) && ('-' == value[0])))
+            {
+                *error += "bad value '" + value + "' of '" + name + "'";
+                return false;
+            }
+            if (!family.samples.insert(line.substr(0, value_start)).second)
+            {
+                *error += "repeated sample '" + line.substr(0, value_start) + "'";
+                return false;
+            }
+            family.has_samples = true;
+        }
+    }
+
+    if (!eof)
+    {
+        *error = "no # EOF";
+        return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    static const char *const malformed[] = {
+        "",
+        "# TYPE a counter\na_total 1\n",
+        "a_total 1\n# EOF\n",
+        "# TYPE a counter\na 1\n# EOF\n",
+        "# TYPE a_total counter\na_total_total 1\n# EOF\n",
+        "# TYPE a counter\n# UNIT a seconds\na_total 1\n# EOF\n",
+        "# TYPE a counter\na_total 1\n# HELP a late\n# EOF\n",
+        "# TYPE a counter\na_total 1\n# TYPE a counter\na_total 2\n# EOF\n",
+        "# TYPE 1a gauge\n1a 1\n# EOF\n",
+        "# TYPE a gauge\na{b=\"1\",b=\"2\"} 1\n# EOF\n",
+        "# TYPE a gauge\na{b=\"1\"} 1\na{b=\"1\"} 2\n# EOF\n",
+        "# TYPE a gauge\na one\n# EOF\n",
+        "# TYPE a counter\na_total -1\n# EOF\n",
+        "# TYPE a gauge\na 1\n# EOF\n\n",
+        "# TYPE a gauge\na 1\n# EOF",
+    };
+    cy_http_response_stream_t stream;
+    std::string error;
+    const char *mime_type;
+
+    host_set_cpu_stats(3600000000ULL, 3000000000ULL, 500000000ULL, 2400000000ULL);
+    host_http_init();
+
+    /* The validator accepts a well-formed exposition and rejects each of
+     * the mistakes above.
+     */
+    CHECK(metrics_validate("# TYPE a_seconds counter\n# UNIT a_seconds seconds\n"
+                           "# HELP a_seconds Help.\na_seconds_total{b=\"x\\\"y\"} 1.5\n"
+                           "# TYPE c gauge\nc 2\n# EOF\n", &error));
+    for (const char *body : malformed)
+    {
+        CHECK(!metrics_validate(body, &error));
+    }
+
+    mime_type = host_http_mime_type("/metrics");
+    CHECK((NULL != mime_type) &&
+          (0 == strcmp(mime_type, "application/openmetrics-text; version=1.0.0; charset=utf-8")));
+
+    CHECK_EQ(host_http_request("/metrics", &stream, NULL), CY_RSLT_SUCCESS);
+    if (!metrics_validate(stream.body, &error))
+    {
+        printf("test_metrics: /metrics: %s\n", error.c_str());
+        test_failures++;
+    }
+
+    return TEST_RESULT("test_metrics");
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,272 @@
+/******************************************************************************
+ * File Name: test_nw_inactivity.cpp
+ *
+ * Description:
+ *   This file contains the host test of the adaptive network inactivity
+ *   window. Traces of the idle gaps between packets are fed through a model of
+ *   wait_net_suspend() and the window the controller settles on is checked.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include <algorithm>
+#include "nw_inactivity.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define WINDOW_MIN_MS    (MBED_CONF_APP_NW_INACTIVE_WINDOW_MIN_MS)
+#define WINDOW_MAX_MS    (MBED_CONF_APP_NW_INACTIVE_WINDOW_MAX_MS)
+
+/* Sleep requests per trace. */
+#define TRACE_REQUESTS   (200)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Outcome of a trace, counted after the controller had time to settle. */
+typedef struct
+{
+    uint32_t window_ms;       /* Window at the end of the trace.           */
+    uint32_t peak_window_ms;  /* Longest window used.                      */
+    uint32_t suspends;        /* Sleep requests that suspended the stack.  */
+    uint32_t paid_off;        /* Suspends at least the break-even time.    */
+    uint32_t abandoned;       /* Sleep requests dropped without a suspend. */
+    uint32_t timeouts;        /* Intervals that found no inactive window.  */
+} trace_result_t;
+
+/* Position in a repeating list of idle gaps between packets. */
+typedef struct
+{
+    const uint32_t *gaps;
+    uint32_t        gap_count;
+    uint32_t        next_gap;
+    uint32_t        into_gap_ms;  /* Time since the last packet. */
+} trace_t;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Time until the next packet. */
+static uint32_t trace_to_packet(const trace_t *trace)
+{
+    return trace->gaps[trace->next_gap] - trace->into_gap_ms;
+}
+
+/* Moves 'ms' forward, past the packets in between. */
+static void trace_advance(trace_t *trace, uint32_t ms)
+{
+    while (ms >= trace_to_packet(trace))
+    {
+        ms -= trace_to_packet(trace);
+        trace->into_gap_ms = 0;
+        trace->next_gap = (trace->next_gap + 1) % trace->gap_count;
+    }
+    trace->into_gap_ms += ms;
+}
+
+/******************************************************************************
+ * Function Name: trace_wait_net_suspend
+ ******************************************************************************
+ * Summary:
+ *   This function models one wait_net_suspend() call on a trace. The call
+ *   watches one interval; the window starts with the call and restarts at
+ *   each packet. If a whole window passes without a packet before the
+ *   interval ends, the stack is suspended and resumed at the next packet;
+ *   otherwise the call returns at the end of the interval.
+ *
+ * Parameters:
+ *   trace: Pointer to the trace, at the time of the call.
+ *   interval_ms: Inactivity interval.
+ *   window_ms: Inactivity window.
+ *   awake_ms: Pointer that receives the time the stack stayed up.
+ *   idle_gap_ms: Pointer that receives the time the stack was suspended.
+ *
+ * Return:
+ *   bool: true if the stack was suspended.
+ *
+ *****************************************************************************/
+static bool trace_wait_net_suspend(trace_t *trace, uint32_t interval_ms, uint32_t window_ms,
+                                   uint32_t *awake_ms, uint32_t *idle_gap_ms)
+{
+    uint32_t last_activity_ms = 0;
+
+    *awake_ms = 0;
+    while ((last_activity_ms + window_ms) <= interval_ms)
+    {
+        if (trace_to_packet(trace) >= window_ms)
+        {
+            *awake_ms = last_activity_ms + window_ms;
+            *idle_gap_ms = trace_to_packet(trace) - window_ms;
+            trace_advance(trace, trace_to_packet(trace));
+            return true;
+        }
+        last_activity_ms += trace_to_packet(trace);
+        trace_advance(trace, trace_to_packet(trace));
+    }
+
+    trace_advance(trace, interval_ms - std::min(last_activity_ms, interval_ms));
+    *awake_ms = interval_ms;
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: trace_run
+ ******************************************************************************
+ * Summary:
+ *   This function feeds a trace through the controller as nw_suspend_run()
+ *   does. The trace is a repeating list of idle gaps between packets. Each
+ *   sleep request watches one interval after the other, shortening the
+ *   window after each interval without an inactive window, until the stack
+ *   is suspended or nw-suspend-search-ms runs out. The next request starts
+ *   where the last one ended.
+ *
+ * Parameters:
+ *   gaps: Idle gaps of the trace in milliseconds.
+ *   gap_count: Number of gaps.
+ *   settle: Number of sleep requests given to the controller to settle
+ *     before the outcome is counted.
+ *   result: Pointer that receives the outcome.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void trace_run(const uint32_t *gaps, uint32_t gap_count, uint32_t settle,
+                      trace_result_t *result)
+{
+    trace_t trace = { gaps, gap_count, 0, 0 };
+    uint32_t interval_ms;
+    uint32_t window_ms;
+    uint32_t search_ms;
+    uint32_t awake_ms;
+    uint32_t idle_gap_ms = 0;
+    bool suspended;
+    bool counted;
+
+    memset(result, 0, sizeof(*result));
+    for (uint32_t request = 0; request < TRACE_REQUESTS; request++)
+    {
+        counted = (request >= settle);
+        search_ms = 0;
+        do
+        {
+            nw_inactivity_get_window(&interval_ms, &window_ms);
+            CHECK_EQ(interval_ms, 2u * window_ms);
+            if (counted && (window_ms > result->peak_window_ms))
+            {
+                result->peak_window_ms = window_ms;
+            }
+
+            suspended = trace_wait_net_suspend(&trace, interval_ms, window_ms,
+                                               &awake_ms, &idle_gap_ms);
+            search_ms += awake_ms;
+            if (!suspended)
+            {
+                nw_inactivity_timeout(search_ms);
+                result->timeouts += counted ? 1 : 0;
+            }
+        } while (!suspended && (search_ms < MBED_CONF_APP_NW_SUSPEND_SEARCH_MS));
+
+        if (suspended)
+        {
+            nw_inactivity_update(search_ms, idle_gap_ms);
+            result->suspends += counted ? 1 : 0;
+            result->paid_off += (counted && (idle_gap_ms >=
+                                             MBED_CONF_APP_NW_SUSPEND_BREAK_EVEN_MS)) ? 1 : 0;
+        }
+        else
+        {
+            result->abandoned += counted ? 1 : 0;
+        }
+    }
+
+    nw_inactivity_get_window(&interval_ms, &result->window_ms);
+}
+
+int main(void)
+{
+    static const uint32_t quiet[] = { 60000 };
+    static const uint32_t steady[] = { 300 };
+    static const uint32_t busy[] = { 20 };
+    static const uint32_t bursty[] = { 100, 100, 100, 100, 100, 100, 100, 100, 100, 5000 };
+    nw_inactivity_info_t info;
+    trace_result_t result;
+
+    nw_inactivity_get_info(&info);
+    CHECK_EQ(info.window_ms, NETWORK_INACTIVE_WINDOW_MS);
+
+    /* Long quiet periods: every suspend pays off, so the window shrinks to
+     * the minimum and the stack is suspended as soon as possible.
+     */
+    trace_run(quiet, 1, 0, &result);
+    CHECK_EQ(result.window_ms, WINDOW_MIN_MS);
+    CHECK_EQ(result.paid_off, TRACE_REQUESTS);
+    CHECK_EQ(result.timeouts, 0u);
+
+    /* A packet every 300 ms: no suspend pays off, and no window longer than
+     * 300 ms is ever found. The window must neither run off to the maximum,
+     * where every interval times out, nor settle there, and no sleep request
+     * may be dropped.
+     */
+    trace_run(steady, 1, 20, &result);
+    CHECK(result.peak_window_ms < WINDOW_MAX_MS);
+    CHECK(result.peak_window_ms <= 2u * steady[0]);
+    CHECK_EQ(result.suspends, TRACE_REQUESTS - 20);
+    CHECK_EQ(result.abandoned, 0u);
+
+    /* No lull at all: every interval times out and shrinks the window, and
+     * each sleep request is dropped once nw-suspend-search-ms has passed,
+     * one interval at a time.
+     */
+    trace_run(busy, 1, 0, &result);
+    CHECK_EQ(result.window_ms, WINDOW_MIN_MS);
+    CHECK_EQ(result.suspends, 0u);
+    CHECK_EQ(result.abandoned, TRACE_REQUESTS);
+    CHECK(result.timeouts >= ((TRACE_REQUESTS - 1) *
+                              (MBED_CONF_APP_NW_SUSPEND_SEARCH_MS / (2u * WINDOW_MIN_MS))));
+
+    /* Bursts with a long pause: the window grows past the gaps inside a
+     * burst, so that most suspends fall in the pause and pay off.
+     */
+    trace_run(bursty, 10, 50, &result);
+    CHECK(result.peak_window_ms < bursty[9]);
+    CHECK_EQ(result.abandoned, 0u);
+    CHECK(result.paid_off >= (result.suspends * 2u / 3u));
+
+    return TEST_RESULT("test_nw_inactivity");
+}
+
+
+/* [] END OF FILE */
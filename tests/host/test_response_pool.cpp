@@ -0,0 +1,206 @@
+/******************************************************************************
+ * File Name: test_response_pool.cpp
+ *
+ * Description:
+ *   This file contains the host test of the HTTP response buffer pool under
+ *   load. Several clients request /stats.json at the same time through slow
+ *   streams, so that the handlers hold every buffer of the pool and the
+ *   requests beyond the pool size find it exhausted.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_platform.h"
+#include "http_webserver_config.h"
+#include "http_response_pool.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define POOL_TEST_CLIENTS         (8)
+#define POOL_TEST_REQUESTS        (200)
+#define POOL_TEST_WRITE_DELAY_US  (200)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+typedef struct
+{
+    uint32_t served;
+    uint32_t exhausted;
+    uint32_t corrupted;
+    uint32_t unexpected;
+} pool_client_result_t;
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+/* Body of /stats.json served with the pool to itself. The statistics do not
+ * change during the test, so every response must match it byte for byte.
+ */
+static std::string pool_reference;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void pool_client(pool_client_result_t *client)
+{
+    for (uint32_t n = 0; n < POOL_TEST_REQUESTS; n++)
+    {
+        cy_http_response_stream_t stream;
+        cy_rslt_t result;
+
+        stream.write_delay_us = POOL_TEST_WRITE_DELAY_US;
+        result = (cy_rslt_t)host_http_request("/stats.json", &stream, NULL);
+
+        if (CY_RSLT_SUCCESS == result)
+        {
+            client->served++;
+            if (stream.body != pool_reference)
+            {
+                client->corrupted++;
+            }
+        }
+        else if ((CY_RSLT_TYPE_ERROR == result) && stream.body.empty() && (0 == stream.writes))
+        {
+            /* An exhausted pool fails the request before anything is sent. */
+            client->exhausted++;
+        }
+        else
+        {
+            client->unexpected++;
+        }
+    }
+}
+
+int main(void)
+{
+    cy_http_response_stream_t stream;
+    http_response_buf_t *held[HTTP_RESPONSE_POOL_SIZE];
+    pool_client_result_t clients[POOL_TEST_CLIENTS] = {};
+    std::vector<std::thread> threads;
+    http_response_pool_stats_t before;
+    http_response_pool_stats_t after;
+    uint32_t served = 0;
+    uint32_t exhausted = 0;
+    int saved_stdout;
+    int null_fd;
+
+    host_set_cpu_stats(3600000000ULL, 3000000000ULL, 500000000ULL, 2400000000ULL);
+    host_http_init();
+
+    CHECK_EQ(host_http_request("/stats.json", &stream, NULL), CY_RSLT_SUCCESS);
+    pool_reference = stream.body;
+    CHECK(!pool_reference.empty());
+
+    /* With every buffer taken, the page fails with the documented error and
+     * sends nothing; it serves again once a buffer is returned.
+     */
+    http_response_pool_get_stats(&before);
+    for (uint32_t i = 0; i < HTTP_RESPONSE_POOL_SIZE; i++)
+    {
+        held[i] = http_response_buf_alloc();
+        CHECK(NULL != held[i]);
+    }
+    stream = cy_http_response_stream_t();
+    CHECK_EQ((cy_rslt_t)host_http_request("/stats.json", &stream, NULL), CY_RSLT_TYPE_ERROR);
+    CHECK(stream.body.empty());
+    CHECK_EQ(stream.writes, 0);
+    http_response_pool_get_stats(&after);
+    CHECK_EQ(after.alloc_failures, before.alloc_failures + 1);
+    CHECK_EQ(after.in_use, HTTP_RESPONSE_POOL_SIZE);
+
+    http_response_buf_free(held[0]);
+    stream = cy_http_response_stream_t();
+    CHECK_EQ(host_http_request("/stats.json", &stream, NULL), CY_RSLT_SUCCESS);
+    CHECK(stream.body == pool_reference);
+    for (uint32_t i = 1; i < HTTP_RESPONSE_POOL_SIZE; i++)
+    {
+        http_response_buf_free(held[i]);
+    }
+
+    /* More clients than buffers, each holding its buffer through a slow
+     * write: the pool runs out, and the requests that got a buffer still
+     * send the whole document.
+     */
+    http_response_pool_get_stats(&before);
+
+    /* Each failed request logs an error; keep them out of the report. */
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+
+    for (uint32_t i = 0; i < POOL_TEST_CLIENTS; i++)
+    {
+        threads.push_back(std::thread(pool_client, &clients[i]));
+    }
+    for (std::thread &t : threads)
+    {
+        t.join();
+    }
+
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+
+    http_response_pool_get_stats(&after);
+
+    for (uint32_t i = 0; i < POOL_TEST_CLIENTS; i++)
+    {
+        CHECK_EQ(clients[i].corrupted, 0);
+        CHECK_EQ(clients[i].unexpected, 0);
+        served    += clients[i].served;
+        exhausted += clients[i].exhausted;
+    }
+    CHECK_EQ(served + exhausted, POOL_TEST_CLIENTS * POOL_TEST_REQUESTS);
+    CHECK(served > 0);
+    CHECK(exhausted > 0);
+    CHECK_EQ(after.alloc_failures - before.alloc_failures, exhausted);
+    CHECK_EQ(after.in_use, 0);
+    CHECK_EQ(after.peak_in_use, HTTP_RESPONSE_POOL_SIZE);
+
+    printf("test_response_pool: %u served, %u failed on an exhausted pool of %u\n",
+           served, exhausted, (unsigned int)HTTP_RESPONSE_POOL_SIZE);
+
+    return TEST_RESULT("test_response_pool");
+}
+
+
+/* [] END OF FILE */
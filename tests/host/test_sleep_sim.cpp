@@ -0,0 +1,239 @@
+/******************************************************************************
+ * File Name: test_sleep_sim.cpp
+ *
+ * Description:
+ *   This file contains the host test of the sleep simulator. Synthetic traces
+ *   are run through the suspend cycle of the application and the deep sleep
+ *   time and the wakes are checked against the packets of the trace.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include "host_platform.h"
+#include "host_sleep_sim.h"
+#include "wake_reason.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define HOUR_MS   (3600000ULL)
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Wake reason the application must find for each packet kind. */
+static const wake_reason_t packet_reasons[HOST_NW_PACKET_MAX] = {
+    WAKE_REASON_ARP,
+    WAKE_REASON_TCP,
+    WAKE_REASON_TCP,
+    WAKE_REASON_TCP,
+    WAKE_REASON_TCP,
+    WAKE_REASON_BROADCAST,
+    WAKE_REASON_PING,
+    WAKE_REASON_UDP,
+    WAKE_REASON_OTHER
+};
+
+static void run(const char *name, bool arp_offload, host_sleep_sim_result_t *result)
+{
+    std::vector<host_nw_packet_t> trace;
+    wake_reason_stats_t wakes_start;
+    wake_reason_stats_t wakes;
+    uint32_t reason_wakes[WAKE_REASON_MAX] = { 0 };
+    uint32_t packet_wakes = 0;
+
+    CHECK(host_sleep_sim_synthetic(name, HOUR_MS, &trace));
+    wake_reason_get_stats(&wakes_start);
+    host_sleep_sim_run(trace, HOUR_MS, arp_offload, result);
+    wake_reason_get_stats(&wakes);
+
+    CHECK(result->duration_ms >= HOUR_MS);
+    CHECK(result->deep_sleep_ms <= result->duration_ms);
+    CHECK_EQ(result->suspend_attempts, result->suspends + result->timeouts);
+
+    /* Every resume by a packet is attributed to the kind of the packet by
+     * its frame, and every other resume, at the end of the run, to a timer.
+     */
+    for (uint32_t i = 0; i < HOST_NW_PACKET_MAX; i++)
+    {
+        reason_wakes[packet_reasons[i]] += result->wakes[i];
+        packet_wakes += result->wakes[i];
+    }
+    reason_wakes[WAKE_REASON_TIMER] = result->suspends - packet_wakes;
+    for (uint32_t i = 0; i < WAKE_REASON_MAX; i++)
+    {
+        CHECK_EQ(wakes.wakes[i] - wakes_start.wakes[i], reason_wakes[i]);
+    }
+}
+
+static void test_load(void)
+{
+    char path[] = "/tmp/test_sleep_sim_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *file = fdopen(fd, "w");
+    std::vector<host_nw_packet_t> trace;
+
+    fprintf(file, "# time kind\n2000 http\n\n1000 arp\n3000 other\n4000 sleep\n");
+    fclose(file);
+    CHECK(host_sleep_sim_load(path, &trace));
+    CHECK_EQ(trace.size(), 4u);
+    CHECK_EQ(trace[0].time_ms, 1000u);
+    CHECK_EQ(trace[0].kind, HOST_NW_PACKET_ARP);
+    CHECK_EQ(trace[1].kind, HOST_NW_PACKET_HTTP);
+    CHECK_EQ(trace[2].kind, HOST_NW_PACKET_OTHER);
+    CHECK_EQ(trace[3].kind, HOST_NW_PACKET_SLEEP);
+
+    file = fopen(path, "w");
+    fprintf(file, "1000 dhcp\n");
+    fclose(file);
+    CHECK(!host_sleep_sim_load(path, &trace));
+    unlink(path);
+
+    CHECK(!host_sleep_sim_load("/nonexistent/trace", &trace));
+    CHECK(!host_sleep_sim_synthetic("unknown", HOUR_MS, &trace));
+}
+
+int main(int argc, char *argv[])
+{
+    host_sleep_sim_result_t result;
+    uint64_t offload_sleep_ms;
+    wake_reason_stats_t wakes;
+
+    test_load();
+    host_http_init();
+
+    /* Only the ARP refresh of the access point, once a minute, and a sleep
+     * request every 5 minutes. The WLAN device answers the ARP requests, so
+     * the host sleeps through the whole hour; each sleep request wakes it
+     * and suspends the stack again.
+     */
+    run("quiet", true, &result);
+    CHECK_EQ(result.sleep_requests, 12u);
+    CHECK_EQ(result.suspends, 12u);
+    CHECK_EQ(result.drain_timeouts, 0u);
+    CHECK_EQ(result.arp_offloaded, 60u);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_ARP], 0u);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_SLEEP], 11u);
+    CHECK(result.deep_sleep_ms > (HOUR_MS * 99 / 100));
+    offload_sleep_ms = result.deep_sleep_ms;
+
+    /* Without ARP offload, the first ARP request after each sleep request
+     * wakes the host, which then stays awake until the next one.
+     */
+    run("quiet", false, &result);
+    CHECK_EQ(result.arp_offloaded, 0u);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_ARP], 12u);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_SLEEP], 0u);
+    CHECK_EQ(result.suspends, 12u);
+    CHECK(result.deep_sleep_ms < (HOUR_MS / 10));
+    CHECK(result.deep_sleep_ms < offload_sleep_ms);
+
+    /* A page load every 10 minutes: each one wakes the host, which stays
+     * awake until the sleep request 5 seconds later. The wakes by page loads
+     * and by sleep requests are counted under TCP port 80, after the sleep
+     * requests that woke the host in the first 'quiet' run.
+     */
+    run("web", true, &result);
+    wake_reason_get_stats(&wakes);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_HTTP], 5u);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_SLEEP], 6u);
+    CHECK_EQ(wakes.ports[0].protocol, WAKE_REASON_IP_PROTO_TCP);
+    CHECK_EQ(wakes.ports[0].port, 80u);
+    CHECK_EQ(wakes.ports[0].wakes, 11u + 11u);
+    CHECK(result.deep_sleep_ms > (HOUR_MS * 98 / 100));
+
+    /* The client ACKs each response 40 ms after the request: the sleep
+     * thread waits for the ACK instead of a fixed time, and the stack is
+     * suspended with nothing left in flight.
+     */
+    CHECK_EQ(result.drain_timeouts, 0u);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_ACK], 0u);
+
+    /* The first ACK of each response to a sleep request is lost, and the
+     * client ACKs the retransmission 3 seconds later. The drain gives up
+     * after http-drain-timeout-ms, the stack is suspended with the response
+     * unacknowledged, and the late ACK wakes the host, which then stays
+     * awake until the next sleep request.
+     */
+    run("lossy", true, &result);
+    CHECK_EQ(result.drain_timeouts, result.sleep_requests);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_ACK], result.sleep_requests);
+    CHECK_EQ(result.suspends, result.sleep_requests);
+    CHECK(result.deep_sleep_ms < (HOUR_MS / 100));
+
+    /* A client keeps its connection open and sends on it every 10 seconds.
+     * Closing the connections before each suspend stops it until its next
+     * request; with the connections kept open, as with
+     * http-evict-before-suspend set to false, its first segment after each
+     * sleep request wakes the host, which then stays awake.
+     */
+    run("keepalive", true, &result);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_KEEPALIVE], 0u);
+    CHECK(result.keepalives_dropped > 0u);
+    CHECK(result.deep_sleep_ms > (HOUR_MS * 98 / 100));
+    offload_sleep_ms = result.deep_sleep_ms;
+
+    host_http_keep_connections(true);
+    run("keepalive", true, &result);
+    host_http_keep_connections(false);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_KEEPALIVE], result.sleep_requests);
+    CHECK_EQ(result.keepalives_dropped, 0u);
+    CHECK(result.deep_sleep_ms < (HOUR_MS / 10));
+    CHECK(result.deep_sleep_ms < offload_sleep_ms);
+
+    /* A broadcast burst every 15 seconds: the first one after each sleep
+     * request wakes the host, and the host stays awake through the others
+     * until the next sleep request.
+     */
+    run("chatty", true, &result);
+    CHECK_EQ(result.wakes[HOST_NW_PACKET_BROADCAST], 12u);
+    CHECK_EQ(result.suspends, 12u);
+    CHECK(result.deep_sleep_ms < (HOUR_MS / 10));
+
+    /* No lull at all: every interval times out, and each sleep request is
+     * dropped once nw-suspend-search-ms has passed.
+     */
+    run("busy", true, &result);
+    CHECK_EQ(result.suspends, 0u);
+    CHECK_EQ(result.abandoned, result.sleep_requests);
+    CHECK(result.timeouts >= (result.abandoned * MBED_CONF_APP_NW_SUSPEND_SEARCH_MS /
+                              MBED_CONF_APP_NW_INACTIVE_WINDOW_MAX_MS / 2));
+    CHECK_EQ(result.deep_sleep_ms, 0u);
+
+    return TEST_RESULT("test_sleep_sim");
+}
+
+
+/* [] END OF FILE */
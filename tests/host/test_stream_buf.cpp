@@ -0,0 +1,250 @@
+/******************************************************************************
+ * File Name: test_stream_buf.cpp
+ *
+ * Description:
+ *   This file contains the host test of the HTTP response stream buffer. A
+ *   large response is written through a small stream buffer and compared byte
+ *   for byte with the expected output.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <inttypes.h>
+#include <string>
+#include "host_platform.h"
+#include "http_response_writer.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+/* Stream buffer size used by the /stats page. */
+#define STREAM_BUF_LEN          (256u)
+
+/* Response length of the randomized test. */
+#define STREAM_TEST_LEN         (64u * 1024u)
+
+/* Longer than the longest number the stream buffer writes, so the boundary
+ * test crosses the point where it flushes before a number.
+ */
+#define NUM_BOUNDARY_SPAN       (32u)
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+static HTTPServer test_server(NULL, 80, 1);
+static uint32_t test_seed = 12345u;
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static uint32_t test_rand(void)
+{
+    test_seed = (test_seed * 1103515245u) + 12345u;
+    return test_seed >> 8;
+}
+
+static uint64_t test_rand_uint64(void)
+{
+    /* Mix short and full-width numbers, including the 64-bit maximum. */
+    switch (test_rand() % 4u)
+    {
+        case 0:
+            return test_rand() % 10u;
+        case 1:
+            return UINT64_MAX;
+        default:
+            return ((uint64_t)test_rand() << 40) ^ ((uint64_t)test_rand() << 16) ^ test_rand();
+    }
+}
+
+static void expect_uint64(std::string *expected, uint64_t value)
+{
+    char str[32];
+
+    snprintf(str, sizeof(str), "%" PRIu64, value);
+    expected->append(str);
+}
+
+static void expect_usec(std::string *expected, uint64_t usec)
+{
+    char str[40];
+
+    snprintf(str, sizeof(str), "%" PRIu64 ".%06" PRIu64, usec / 1000000u, usec % 1000000u);
+    expected->append(str);
+}
+
+static void test_random_writes(void)
+{
+    char buf[STREAM_BUF_LEN];
+    char data[3u * STREAM_BUF_LEN];
+    http_stream_buf_t sb;
+    cy_http_response_stream_t stream;
+    std::string expected;
+    uint32_t length;
+    uint64_t value;
+
+    http_stream_buf_init(&sb, &test_server, &stream, buf, sizeof(buf));
+
+    while (expected.size() < STREAM_TEST_LEN)
+    {
+        switch (test_rand() % 4u)
+        {
+            case 0:
+                /* Raw data, sometimes longer than the buffer itself. */
+                length = test_rand() % sizeof(data);
+                for (uint32_t i = 0; i < length; i++)
+                {
+                    data[i] = (char)(' ' + (test_rand() % 95u));
+                }
+                http_stream_buf_write(&sb, data, length);
+                expected.append(data, length);
+                break;
+
+            case 1:
+                http_stream_buf_write_str(&sb, "\t:");
+                expected.append("\t:");
+                break;
+
+            case 2:
+                value = test_rand_uint64();
+                http_stream_buf_write_uint64(&sb, value);
+                expect_uint64(&expected, value);
+                break;
+
+            default:
+                value = test_rand_uint64();
+                http_stream_buf_write_usec(&sb, value);
+                expect_usec(&expected, value);
+                break;
+        }
+    }
+
+    CHECK_EQ(http_stream_buf_flush(&sb), CY_RSLT_SUCCESS);
+    CHECK_EQ(stream.body.size(), expected.size());
+    CHECK(stream.body == expected);
+    CHECK(stream.max_write <= STREAM_BUF_LEN);
+    CHECK(stream.writes >= (expected.size() / STREAM_BUF_LEN));
+}
+
+static void test_number_boundary(bool usec)
+{
+    char buf[STREAM_BUF_LEN];
+    http_stream_buf_t sb;
+    std::string expected;
+    std::string fill;
+
+    /* Leave 0 to NUM_BOUNDARY_SPAN bytes free in the buffer before a number,
+     * so the number is written before, across, and after the point where the
+     * buffer is flushed to make room for it.
+     */
+    for (uint32_t free_len = 0; free_len <= NUM_BOUNDARY_SPAN; free_len++)
+    {
+        cy_http_response_stream_t stream;
+
+        expected.clear();
+        http_stream_buf_init(&sb, &test_server, &stream, buf, sizeof(buf));
+
+        fill.assign(STREAM_BUF_LEN - free_len, (char)('a' + (free_len % 26u)));
+        http_stream_buf_write(&sb, fill.data(), fill.size());
+        expected.append(fill);
+
+        if (usec)
+        {
+            http_stream_buf_write_usec(&sb, UINT64_MAX);
+            expect_usec(&expected, UINT64_MAX);
+        }
+        else
+        {
+            http_stream_buf_write_uint64(&sb, UINT64_MAX);
+            expect_uint64(&expected, UINT64_MAX);
+        }
+
+        http_stream_buf_write_str(&sb, "\n");
+        expected.append("\n");
+
+        CHECK_EQ(http_stream_buf_flush(&sb), CY_RSLT_SUCCESS);
+        CHECK(stream.body == expected);
+        CHECK(stream.max_write <= STREAM_BUF_LEN);
+    }
+}
+
+static void test_write_error(void)
+{
+    char buf[STREAM_BUF_LEN];
+    char data[STREAM_BUF_LEN];
+    http_stream_buf_t sb;
+    cy_http_response_stream_t stream;
+
+    /* The first write error is kept and stops further output. */
+    stream.fail_at_write = 2;
+    memset(data, 'x', sizeof(data));
+    http_stream_buf_init(&sb, &test_server, &stream, buf, sizeof(buf));
+
+    for (uint32_t i = 0; i < 4u; i++)
+    {
+        http_stream_buf_write(&sb, data, sizeof(data));
+        http_stream_buf_write_uint64(&sb, UINT64_MAX);
+    }
+
+    CHECK(CY_RSLT_SUCCESS != http_stream_buf_flush(&sb));
+    CHECK_EQ(stream.writes, 2u);
+    CHECK_EQ(stream.body.size(), STREAM_BUF_LEN);
+}
+
+static void test_small_buffer(void)
+{
+    char buf[8];
+    http_stream_buf_t sb;
+    cy_http_response_stream_t stream;
+
+    /* A buffer that cannot hold a number is refused. */
+    http_stream_buf_init(&sb, &test_server, &stream, buf, sizeof(buf));
+    http_stream_buf_write_str(&sb, "x");
+
+    CHECK(CY_RSLT_SUCCESS != http_stream_buf_flush(&sb));
+    CHECK_EQ(stream.writes, 0u);
+}
+
+int main(void)
+{
+    test_random_writes();
+    test_number_boundary(false);
+    test_number_boundary(true);
+    test_write_error();
+    test_small_buffer();
+
+    return TEST_RESULT("test_stream_buf");
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,77 @@
+/******************************************************************************
+ * File Name: test_util.h
+ *
+ * Description:
+ *   This file contains the check macros shared by the host tests. A failed
+ *   check is reported with its location and makes the test exit with 1.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdio.h>
+
+static int test_failures;
+
+#define CHECK(expr)                                                        \
+    do                                                                     \
+    {                                                                      \
+        if (!(expr))                                                       \
+        {                                                                  \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            test_failures++;                                               \
+        }                                                                  \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                         \
+    do                                                                     \
+    {                                                                      \
+        unsigned long long test_actual = (unsigned long long)(actual);     \
+        unsigned long long test_expected = (unsigned long long)(expected); \
+        if (test_actual != test_expected)                                  \
+        {                                                                  \
+            printf("%s:%d: %s is %llu, expected %llu\n", __FILE__, __LINE__, \
+                   #actual, test_actual, test_expected);                   \
+            test_failures++;                                               \
+        }                                                                  \
+    } while (0)
+
+#define TEST_RESULT(name)                                                  \
+    (printf("%s: %s\n", (name), (0 == test_failures) ? "PASS" : "FAIL"),   \
+     (0 == test_failures) ? 0 : 1)
+
+#endif /* #ifndef TEST_UTIL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,345 @@
+/******************************************************************************
+ * File Name: test_wake_reason.cpp
+ *
+ * Description:
+ *   This file contains the host test of the wake reasons. Ethernet frames of
+ *   each kind are classified, and frames passed to the wrapped interface
+ *   while the stack looks for an inactive window show that only the frame
+ *   after a whole window is taken as the one that resumed the stack, and
+ *   that the time from that frame to the resume is the resume latency.
+ *
+ ******************************************************************************
+ * Copyright (2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "host_platform.h"
+#include "wake_reason.h"
+#include "app_stats.h"
+#include "lwip/netif.h"
+#include "test_util.h"
+
+/******************************************************************************
+ *                              MACROS
+ *****************************************************************************/
+#define FRAME_LEN        (96)
+#define ETH_TYPE_IPV4    (0x0800)
+#define ETH_TYPE_ARP     (0x0806)
+#define ETH_TYPE_VLAN    (0x8100)
+#define ETH_TYPE_IPV6    (0x86DD)
+#define ETH_TYPE_EAPOL   (0x888E)
+
+#define WINDOW_MS        (100)
+
+/******************************************************************************
+ *                            TYPE DEFINITIONS
+ *****************************************************************************/
+/* Frame to build: the destination address, EtherType, whether a VLAN tag
+ * comes first, and for IP the protocol, the IPv4 header length, the
+ * fragment offset, the first byte of the transport header and the
+ * destination port.
+ */
+typedef struct
+{
+    const uint8_t *dst_mac;
+    uint16_t       type;
+    bool           vlan;
+    uint8_t        protocol;
+    uint8_t        ipv4_header_len;
+    uint16_t       fragment;
+    uint8_t        l4_first;
+    uint16_t       port;
+} frame_spec_t;
+
+/******************************************************************************
+ *                             GLOBALS
+ *****************************************************************************/
+static const uint8_t device_mac[6]    = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x05 };
+static const uint8_t broadcast_mac[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static const uint8_t ipv6_all_mac[6]  = { 0x33, 0x33, 0x00, 0x00, 0x00, 0x01 };
+
+/******************************************************************************
+ *                        FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void put_u16(uint8_t *field, uint16_t value)
+{
+    field[0] = (uint8_t)(value >> 8);
+    field[1] = (uint8_t)value;
+}
+
+static uint16_t build_frame(const frame_spec_t &spec, uint8_t *frame)
+{
+    uint32_t offset = 12;
+    uint32_t header_len;
+
+    memset(frame, 0, FRAME_LEN);
+    memcpy(frame, spec.dst_mac, 6);
+    frame[6] = 0x02;
+    frame[11] = 0x01;
+    if (spec.vlan)
+    {
+        put_u16(&frame[offset], ETH_TYPE_VLAN);
+        offset += 4;
+    }
+    put_u16(&frame[offset], spec.type);
+    offset += 2;
+
+    if (ETH_TYPE_IPV4 == spec.type)
+    {
+        header_len = (0 != spec.ipv4_header_len) ? spec.ipv4_header_len : 20;
+        frame[offset] = (uint8_t)(0x40 | (header_len / 4));
+        put_u16(&frame[offset + 6], spec.fragment);
+        frame[offset + 9] = spec.protocol;
+    }
+    else if (ETH_TYPE_IPV6 == spec.type)
+    {
+        header_len = 40;
+        frame[offset] = 0x60;
+        frame[offset + 6] = spec.protocol;
+    }
+    else
+    {
+        return (uint16_t)(offset + 28);
+    }
+
+    offset += header_len;
+    frame[offset] = spec.l4_first;
+    put_u16(&frame[offset + 2], spec.port);
+
+    return (uint16_t)(offset + 8);
+}
+
+static wake_reason_t classify(const frame_spec_t &spec, uint16_t *port)
+{
+    uint8_t frame[FRAME_LEN];
+    uint16_t length = build_frame(spec, frame);
+
+    return wake_reason_classify(frame, length, port);
+}
+
+static void receive(const frame_spec_t &spec)
+{
+    uint8_t frame[FRAME_LEN];
+    uint16_t length = build_frame(spec, frame);
+
+    host_nw_receive(frame, length);
+}
+
+static void test_classify(void)
+{
+    uint8_t frame[FRAME_LEN];
+    uint16_t length;
+    uint16_t port = 1;
+
+    /* ARP comes before the broadcast address, and any other frame to a
+     * group address is a broadcast, whatever it carries.
+     */
+    CHECK_EQ(classify({ broadcast_mac, ETH_TYPE_ARP, false, 0, 0, 0, 0, 0 }, &port), WAKE_REASON_ARP);
+    CHECK_EQ(port, 0u);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_ARP, false, 0, 0, 0, 0, 0 }, &port), WAKE_REASON_ARP);
+    CHECK_EQ(classify({ broadcast_mac, ETH_TYPE_IPV4, false, 17, 0, 0, 0, 68 }, &port),
+             WAKE_REASON_BROADCAST);
+    CHECK_EQ(port, 0u);
+    CHECK_EQ(classify({ ipv6_all_mac, ETH_TYPE_IPV6, false, 58, 0, 0, 135, 0 }, &port),
+             WAKE_REASON_BROADCAST);
+
+    /* Echo requests are pings; other ICMP messages are not. */
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV4, false, 1, 0, 0, 8, 0 }, &port),
+             WAKE_REASON_PING);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV4, false, 1, 0, 0, 0, 0 }, &port),
+             WAKE_REASON_OTHER);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV6, false, 58, 0, 0, 128, 0 }, &port),
+             WAKE_REASON_PING);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV6, false, 58, 0, 0, 8, 0 }, &port),
+             WAKE_REASON_OTHER);
+
+    /* TCP and UDP return the destination port, behind a VLAN tag, IPv4
+     * options, or an IPv6 header.
+     */
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV4, false, 6, 0, 0, 0, 80 }, &port),
+             WAKE_REASON_TCP);
+    CHECK_EQ(port, 80u);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV4, true, 17, 0, 0, 0, 5004 }, &port),
+             WAKE_REASON_UDP);
+    CHECK_EQ(port, 5004u);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV4, false, 6, 24, 0, 0, 22 }, &port),
+             WAKE_REASON_TCP);
+    CHECK_EQ(port, 22u);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV6, false, 17, 0, 0, 0, 546 }, &port),
+             WAKE_REASON_UDP);
+    CHECK_EQ(port, 546u);
+
+    /* A later fragment has no transport header, and other protocols and
+     * EtherTypes are only told apart from the rest.
+     */
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV4, false, 17, 0, 185, 0, 5004 }, &port),
+             WAKE_REASON_OTHER);
+    CHECK_EQ(port, 0u);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_IPV4, false, 47, 0, 0, 0, 0 }, &port),
+             WAKE_REASON_OTHER);
+    CHECK_EQ(classify({ device_mac, ETH_TYPE_EAPOL, false, 0, 0, 0, 0, 0 }, &port), WAKE_REASON_OTHER);
+
+    /* Frames too short to tell are not read past their end. */
+    length = build_frame({ device_mac, ETH_TYPE_IPV4, false, 6, 0, 0, 0, 80 }, frame);
+    CHECK_EQ(wake_reason_classify(frame, 10, &port), WAKE_REASON_OTHER);
+    CHECK_EQ(wake_reason_classify(frame, 14 + 19, &port), WAKE_REASON_OTHER);
+    CHECK_EQ(wake_reason_classify(frame, length - 5, &port), WAKE_REASON_OTHER);
+    CHECK_EQ(wake_reason_classify(frame, length - 4, &port), WAKE_REASON_TCP);
+}
+
+static void test_watch(void)
+{
+    wake_reason_stats_t start;
+    wake_reason_stats_t stats;
+    struct pbuf p = { NULL, NULL, 0, 0 };
+
+    wake_reason_get_stats(&start);
+
+    /* Frames closer than the window keep the stack up, and so does a frame
+     * sent. The first frame after a whole window resumed the stack; the
+     * frames after it do not change the reason.
+     */
+    wake_reason_watch(WINDOW_MS);
+    host_clock_advance_ms(WINDOW_MS - 1);
+    receive({ device_mac, ETH_TYPE_IPV4, false, 17, 0, 0, 0, 5004 });
+    host_clock_advance_ms(WINDOW_MS - 1);
+    netif_default->linkoutput(netif_default, &p);
+    host_clock_advance_ms(WINDOW_MS - 1);
+    receive({ device_mac, ETH_TYPE_IPV4, false, 1, 0, 0, 8, 0 });
+    host_clock_advance_ms(WINDOW_MS);
+    receive({ device_mac, ETH_TYPE_IPV4, false, 6, 0, 0, 0, 443 });
+    receive({ broadcast_mac, ETH_TYPE_ARP, false, 0, 0, 0, 0, 0 });
+    wake_reason_resumed();
+    host_clock_advance_ms(300);
+    wake_reason_suspending();
+
+    wake_reason_get_stats(&stats);
+    CHECK_EQ(stats.wakes[WAKE_REASON_TCP] - start.wakes[WAKE_REASON_TCP], 1u);
+    CHECK_EQ(stats.wakes[WAKE_REASON_PING] - start.wakes[WAKE_REASON_PING], 0u);
+    CHECK_EQ(stats.wakes[WAKE_REASON_UDP] - start.wakes[WAKE_REASON_UDP], 0u);
+    CHECK_EQ(stats.wakes[WAKE_REASON_ARP] - start.wakes[WAKE_REASON_ARP], 0u);
+    CHECK_EQ(stats.awake_ms[WAKE_REASON_TCP] - start.awake_ms[WAKE_REASON_TCP], 300u);
+    CHECK_EQ(stats.ports[0].protocol, WAKE_REASON_IP_PROTO_TCP);
+    CHECK_EQ(stats.ports[0].port, 443u);
+    CHECK_EQ(stats.ports[0].wakes, 1u);
+
+    /* The window starts again with each call, and frames outside a watch
+     * are not taken. A resume without a frame is a timer.
+     */
+    receive({ device_mac, ETH_TYPE_IPV4, false, 1, 0, 0, 8, 0 });
+    host_clock_advance_ms(WINDOW_MS);
+    wake_reason_watch(WINDOW_MS);
+    receive({ device_mac, ETH_TYPE_IPV4, false, 1, 0, 0, 8, 0 });
+    wake_reason_resumed();
+    wake_reason_suspending();
+    wake_reason_get_stats(&stats);
+    CHECK_EQ(stats.wakes[WAKE_REASON_PING] - start.wakes[WAKE_REASON_PING], 0u);
+    CHECK_EQ(stats.wakes[WAKE_REASON_TIMER] - start.wakes[WAKE_REASON_TIMER], 1u);
+}
+
+static void test_ports(void)
+{
+    wake_reason_stats_t stats;
+
+    /* The ports are kept in the order they first woke the host, until the
+     * table is full; further ports are only counted by protocol.
+     */
+    for (uint16_t port = 1; port <= WAKE_REASON_PORTS + 1; port++)
+    {
+        wake_reason_watch(WINDOW_MS);
+        host_clock_advance_ms(WINDOW_MS);
+        receive({ device_mac, ETH_TYPE_IPV4, false, 17, 0, 0, 0, port });
+        wake_reason_resumed();
+        wake_reason_suspending();
+    }
+
+    wake_reason_get_stats(&stats);
+    CHECK_EQ(stats.ports[0].port, 443u);
+    for (uint32_t i = 1; i < WAKE_REASON_PORTS; i++)
+    {
+        CHECK_EQ(stats.ports[i].protocol, WAKE_REASON_IP_PROTO_UDP);
+        CHECK_EQ(stats.ports[i].port, i);
+        CHECK_EQ(stats.ports[i].wakes, 1u);
+    }
+    CHECK_EQ(stats.wakes[WAKE_REASON_UDP], WAKE_REASON_PORTS + 1);
+}
+
+static void test_resume_latency(void)
+{
+    log2_histogram_t start;
+    log2_histogram_t snapshot;
+    uint32_t total = 0;
+
+    app_stats_get_histogram(APP_STATS_HIST_RESUME_LATENCY, &start);
+
+    /* The latency runs from the wake frame to the resume; the frames that
+     * only restart the window do not count, and a resume without a frame
+     * records nothing.
+     */
+    wake_reason_watch(WINDOW_MS);
+    host_clock_advance_ms(WINDOW_MS - 1);
+    receive({ device_mac, ETH_TYPE_IPV4, false, 17, 0, 0, 0, 5004 });
+    host_clock_advance_ms(WINDOW_MS);
+    receive({ device_mac, ETH_TYPE_IPV4, false, 1, 0, 0, 8, 0 });
+    host_clock_advance_ms(3);
+    wake_reason_resumed();
+    wake_reason_suspending();
+    wake_reason_watch(WINDOW_MS);
+    host_clock_advance_ms(WINDOW_MS);
+    wake_reason_resumed();
+    wake_reason_suspending();
+
+    app_stats_get_histogram(APP_STATS_HIST_RESUME_LATENCY, &snapshot);
+    CHECK_EQ(log2_histogram_bucket_min(2), 2u);
+    CHECK_EQ(log2_histogram_bucket_min(3), 4u);
+    CHECK_EQ(snapshot.counts[2] - start.counts[2], 1u);
+    for (uint32_t i = 0; i < LOG2_HISTOGRAM_BUCKETS; i++)
+    {
+        total += snapshot.counts[i] - start.counts[i];
+    }
+    CHECK_EQ(total, 1u);
+}
+
+int main(void)
+{
+    host_clock_set_ms(1000);
+    host_http_init();
+
+    test_classify();
+    test_watch();
+    test_ports();
+    test_resume_latency();
+
+    return TEST_RESULT("test_wake_reason");
+}
+
+
+/* [] END OF FILE */